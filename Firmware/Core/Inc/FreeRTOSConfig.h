@@ -52,10 +52,70 @@
 #define configCHECK_FOR_STACK_OVERFLOW          0
 #define configUSE_MALLOC_FAILED_HOOK            0
 #define configUSE_APPLICATION_TASK_TAG          0
-#define configGENERATE_RUN_TIME_STATS           0
+
+/* Per-task run time in CPU cycles, read from the DWT cycle counter that
+ * dwt_init() starts in main(); summarised by rtos_stats.c.  Set
+ * BRIDGE_RTOS_STATS to 0 (with -D) to drop the cost from every switch. */
+#ifndef BRIDGE_RTOS_STATS
+#define BRIDGE_RTOS_STATS                       1
+#endif
+#define configGENERATE_RUN_TIME_STATS           BRIDGE_RTOS_STATS
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() ( ( void ) 0 )
+#define portGET_RUN_TIME_COUNTER_VALUE()        ( DWT->CYCCNT )
+
 #define configUSE_TRACE_FACILITY                1
 #define configUSE_STATS_FORMATTING_FUNCTIONS    0
 
+/* ---- Trace hooks --------------------------------------------------------
+ * Expanded inside tasks.c, where pxCurrentTCB, pxIdleTaskHandle and the
+ * ready lists are visible.  The switch hooks are shared: each feature
+ * supplies its part and traceTASK_SWITCHED_IN/OUT run them in turn.
+ * --------------------------------------------------------------------- */
+
+/* Idle time for the FIFT telemetry CPU load (fifo_tele.h) */
+#if defined(BRIDGE_TELEMETRY) && BRIDGE_TELEMETRY
+void fifo_tele_idle_in(void);
+void fifo_tele_idle_out(void);
+#define BRIDGE_TELE_SWITCHED_IN() \
+    if( pxCurrentTCB == pxIdleTaskHandle ) { fifo_tele_idle_in(); }
+#define BRIDGE_TELE_SWITCHED_OUT() \
+    if( pxCurrentTCB == pxIdleTaskHandle ) { fifo_tele_idle_out(); }
+#else
+#define BRIDGE_TELE_SWITCHED_IN()
+#define BRIDGE_TELE_SWITCHED_OUT()
+#endif
+
+/* Context-switch and event trace ring (rtos_trace.h) */
+#include "rtos_trace.h"
+#if BRIDGE_RTOS_TRACE
+#define BRIDGE_TRACE_SWITCHED_IN() \
+    rtos_trace_put( RTOS_TRACE_SWITCH_IN, pxCurrentTCB->uxTCBNumber, 0 )
+#define BRIDGE_TRACE_SWITCHED_OUT() \
+    rtos_trace_put( RTOS_TRACE_SWITCH_OUT, pxCurrentTCB->uxTCBNumber, \
+                    listLIST_ITEM_CONTAINER( &( pxCurrentTCB->xStateListItem ) ) == \
+                    &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ) )
+#define traceTASK_CREATE( pxNewTCB ) \
+    rtos_trace_task( ( pxNewTCB )->uxTCBNumber, ( pxNewTCB )->pcTaskName )
+#define traceTASK_INCREMENT_TICK( xTickCount ) \
+    rtos_trace_put( RTOS_TRACE_TICK, pxCurrentTCB->uxTCBNumber, ( xTickCount ) )
+#define traceTASK_NOTIFY( uxIndexToNotify ) \
+    rtos_trace_put( RTOS_TRACE_NOTIFY, pxTCB->uxTCBNumber, ( uxIndexToNotify ) )
+#define traceTASK_NOTIFY_FROM_ISR( uxIndexToNotify ) \
+    rtos_trace_put( RTOS_TRACE_NOTIFY_ISR, pxTCB->uxTCBNumber, __get_IPSR() )
+#define traceTASK_NOTIFY_WAIT_BLOCK( uxIndexToWait ) \
+    rtos_trace_put( RTOS_TRACE_WAIT, pxCurrentTCB->uxTCBNumber, ( uxIndexToWait ) )
+#define traceTASK_NOTIFY_TAKE_BLOCK( uxIndexToWait ) \
+    rtos_trace_put( RTOS_TRACE_WAIT, pxCurrentTCB->uxTCBNumber, ( uxIndexToWait ) )
+#else
+#define BRIDGE_TRACE_SWITCHED_IN()
+#define BRIDGE_TRACE_SWITCHED_OUT()
+#endif
+
+#define traceTASK_SWITCHED_IN() \
+    { BRIDGE_TELE_SWITCHED_IN(); BRIDGE_TRACE_SWITCHED_IN(); }
+#define traceTASK_SWITCHED_OUT() \
+    { BRIDGE_TELE_SWITCHED_OUT(); BRIDGE_TRACE_SWITCHED_OUT(); }
+
 /* ---- Co-routines ------------------------------------------------------- */
 #define configUSE_CO_ROUTINES                   0
 #define configMAX_CO_ROUTINE_PRIORITIES         1
@@ -85,7 +145,7 @@
 #define INCLUDE_vTaskDelay                      1
 #define INCLUDE_xTaskGetSchedulerState          1
 #define INCLUDE_xTaskGetCurrentTaskHandle       1
-#define INCLUDE_uxTaskGetStackHighWaterMark     0
+#define INCLUDE_uxTaskGetStackHighWaterMark     1
 #define INCLUDE_uxTaskGetStackHighWaterMark2    0
 #define INCLUDE_xTaskGetIdleTaskHandle          0
 #define INCLUDE_eTaskGetState                   1
@@ -0,0 +1,205 @@
+/**
+ * @file bip_buffer.h
+ * @brief Lock-free single-producer / single-consumer bip-buffer for
+ *        block-oriented producers and consumers (DMA, MDMA, USB, SDMMC).
+ *
+ * A ring buffer splits any span that crosses the physical end of storage in
+ * two, which forces a block engine into two transfers or a bounce copy.  A
+ * bip-buffer never does: bip_reserve() always hands out ONE contiguous
+ * region of exactly the requested size, skipping the unused tail of storage
+ * when it has to wrap, and bip_peek() always returns one contiguous readable
+ * region.  A whole burst therefore fits one DMA descriptor.
+ *
+ * State (all offsets into buf[], 0..size):
+ *   write      – end of committed data            (written by producer)
+ *   watermark  – end of valid data before a wrap  (written by producer)
+ *   read       – start of unconsumed data         (written by consumer)
+ *
+ * When write >= read the valid data is [read, write).  After the producer
+ * wraps, write < read and the valid data is [read, watermark) followed by
+ * [0, write); the consumer moves read back to 0 when it reaches watermark.
+ *
+ * As with ring_buffer.h, exactly ONE producer and ONE consumer may run
+ * concurrently; indices are volatile and a compiler barrier orders data
+ * against index updates.  If a DMA engine reads or writes the regions,
+ * cache maintenance on the handed-out region is the caller's job (see the
+ * cache note in ring_buffer.h).
+ */
+
+#ifndef BIP_BUFFER_H
+#define BIP_BUFFER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef struct {
+    uint8_t  *buf;                /**< Caller-provided storage */
+    uint32_t  size;               /**< Storage size in bytes (any value) */
+    volatile uint32_t write;      /**< Written by producer */
+    volatile uint32_t watermark;  /**< Written by producer */
+    volatile uint32_t read;       /**< Written by consumer */
+    uint32_t  reserve_start;      /**< Producer-private: start of grant */
+    uint32_t  reserve_len;        /**< Producer-private: length of grant */
+} bip_buffer_t;
+
+/**
+ * @brief Initialise a bip-buffer over caller-provided storage.
+ *
+ * @param storage  Backing array; must outlive the buffer.  Align it to the
+ *                 DMA/cache-line requirement of the block engine in use.
+ * @param size     Size of @p storage in bytes (no power-of-two requirement).
+ * @return false if @p storage is NULL or @p size is 0.
+ */
+static inline bool bip_init(bip_buffer_t *bb, uint8_t *storage, uint32_t size)
+{
+    if (storage == NULL || size == 0u) {
+        return false;
+    }
+    bb->buf           = storage;
+    bb->size          = size;
+    bb->write         = 0u;
+    bb->watermark     = size;
+    bb->read          = 0u;
+    bb->reserve_start = 0u;
+    bb->reserve_len   = 0u;
+    return true;
+}
+
+/**
+ * @brief Producer: reserve exactly @p n contiguous bytes.
+ *
+ * The region stays private to the producer until bip_commit().  Only one
+ * reservation may be outstanding at a time.
+ *
+ * @param[out] ptr  Start of the region on success.
+ * @return false if no contiguous region of @p n bytes is free right now.
+ */
+static inline bool bip_reserve(bip_buffer_t *bb, uint32_t n, uint8_t **ptr)
+{
+    uint32_t write = bb->write;
+    uint32_t read  = bb->read;
+    uint32_t start;
+
+    if (n == 0u) {
+        return false;
+    }
+
+    if (write < read) {
+        /* Already wrapped: must stay strictly below read */
+        if (write + n >= read) {
+            return false;
+        }
+        start = write;
+    } else if (write + n <= bb->size) {
+        /* Fits after the committed data */
+        start = write;
+    } else if (n < read) {
+        /* Wrap: skip the tail [write, size) and start again at 0 */
+        start = 0u;
+    } else {
+        return false;
+    }
+
+    bb->reserve_start = start;
+    bb->reserve_len   = n;
+    *ptr = &bb->buf[start];
+    return true;
+}
+
+/**
+ * @brief Producer: reserve the largest contiguous free region.
+ *
+ * Useful for byte-stream producers that fill as much as they can and
+ * commit the amount actually produced.
+ *
+ * @param[out] ptr  Start of the region (valid only if the return is > 0).
+ * @return Length of the region in bytes (0 when full).
+ */
+static inline uint32_t bip_reserve_max(bip_buffer_t *bb, uint8_t **ptr)
+{
+    uint32_t write = bb->write;
+    uint32_t read  = bb->read;
+    uint32_t n;
+
+    if (write < read) {
+        n = read - write - 1u;
+    } else {
+        uint32_t tail = bb->size - write;
+        uint32_t head = (read > 0u) ? read - 1u : 0u;
+        n = (tail >= head) ? tail : head;
+    }
+
+    if (n == 0u || !bip_reserve(bb, n, ptr)) {
+        return 0u;
+    }
+    return n;
+}
+
+/**
+ * @brief Producer: publish the first @p used bytes of the reservation.
+ *
+ * @p used may be smaller than the reserved length; the rest is returned to
+ * the free space.
+ */
+static inline void bip_commit(bip_buffer_t *bb, uint32_t used)
+{
+    uint32_t write = bb->write;
+    uint32_t new_write;
+
+    if (used > bb->reserve_len) {
+        used = bb->reserve_len;
+    }
+    new_write = bb->reserve_start + used;
+
+    if (new_write < write && write != bb->size) {
+        /* Wrapped: remember where the valid data before the wrap ends */
+        bb->watermark = write;
+    } else if (new_write > bb->watermark) {
+        /* Passed the old watermark: no wrap pending any more */
+        bb->watermark = bb->size;
+    }
+
+    bb->reserve_len = 0u;
+
+    /* Watermark and data must be visible before the write index moves */
+    __asm volatile ("" ::: "memory");
+    bb->write = new_write;
+}
+
+/**
+ * @brief Consumer: expose the contiguous readable region.
+ *
+ * @param[out] ptr  Start of the region (valid only if the return is > 0).
+ * @return Length of the region in bytes (0 when empty).
+ */
+static inline uint32_t bip_peek(bip_buffer_t *bb, const uint8_t **ptr)
+{
+    uint32_t write = bb->write;
+    __asm volatile ("" ::: "memory");
+    uint32_t watermark = bb->watermark;
+    uint32_t read      = bb->read;
+
+    /* Reached the end of pre-wrap data: follow the producer back to 0 */
+    if (read == watermark && write < read) {
+        read = 0u;
+        bb->read = 0u;
+    }
+
+    uint32_t end = (write < read) ? watermark : write;
+    *ptr = &bb->buf[read];
+    return end - read;
+}
+
+/**
+ * @brief Consumer: hand @p n peeked bytes back to the producer.
+ *
+ * @p n must not exceed the length returned by the matching bip_peek().
+ */
+static inline void bip_release(bip_buffer_t *bb, uint32_t n)
+{
+    __asm volatile ("" ::: "memory");
+    bb->read += n;
+}
+
+#endif /* BIP_BUFFER_H */
@@ -0,0 +1,124 @@
+/**
+ * @file block_queue.h
+ * @brief Fixed-size data blocks and a lock-free SPSC queue of block
+ *        pointers for the FT2232HL FIFO bridge running on STM32H750.
+ *
+ * Instead of streaming individual bytes through a ring buffer, the block
+ * pipeline passes whole blocks between ReaderTask and WriterTask by
+ * pointer:
+ *
+ *      free queue:  WriterTask ──► ReaderTask   (empty blocks)
+ *      full queue:  ReaderTask ──► WriterTask   (filled blocks)
+ *
+ * Each queue has exactly one producer and one consumer, so the same
+ * volatile-index / compiler-barrier scheme as ring_buffer.h applies.  Only
+ * a pointer moves per block; data is never copied, and later stages (CRC,
+ * telemetry, DMA) can work on a whole block at once.
+ *
+ * Blocks are cache-line aligned with the payload first, so data[] can be
+ * handed to a DMA engine directly.
+ */
+
+#ifndef BLOCK_QUEUE_H
+#define BLOCK_QUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/** Payload bytes per block (multiple of 32 for cache maintenance) */
+#ifndef BLOCK_DATA_SIZE
+#define BLOCK_DATA_SIZE    2048u
+#endif
+
+/** Queue capacity in blocks (power of two, ≥ number of blocks in the pool) */
+#ifndef BLOCK_QUEUE_DEPTH
+#define BLOCK_QUEUE_DEPTH  128u
+#endif
+
+_Static_assert((BLOCK_DATA_SIZE % 32u) == 0u,
+               "BLOCK_DATA_SIZE must be a multiple of the cache line");
+_Static_assert((BLOCK_QUEUE_DEPTH & (BLOCK_QUEUE_DEPTH - 1u)) == 0u,
+               "BLOCK_QUEUE_DEPTH must be a power of two");
+
+typedef struct {
+    uint8_t  data[BLOCK_DATA_SIZE];  /**< Payload (cache-line aligned) */
+    uint32_t len;                    /**< Valid bytes in data[] */
+    uint32_t timestamp;              /**< DWT cycle count of the first byte */
+} __attribute__((aligned(32))) block_t;
+
+typedef struct {
+    block_t *slot[BLOCK_QUEUE_DEPTH];
+    volatile uint32_t head;  /**< Written by producer */
+    volatile uint32_t tail;  /**< Written by consumer */
+} blkq_t;
+
+/**
+ * @brief Initialise an empty block queue.
+ */
+static inline void blkq_init(blkq_t *q)
+{
+    q->head = 0u;
+    q->tail = 0u;
+}
+
+/**
+ * @brief Number of blocks currently queued.
+ */
+static inline uint32_t blkq_count(const blkq_t *q)
+{
+    return q->head - q->tail;
+}
+
+/**
+ * @brief Producer: enqueue a block.  Returns false if the queue is full.
+ */
+static inline bool blkq_push(blkq_t *q, block_t *blk)
+{
+    uint32_t head = q->head;
+    if (head - q->tail == BLOCK_QUEUE_DEPTH) {
+        return false;
+    }
+    q->slot[head & (BLOCK_QUEUE_DEPTH - 1u)] = blk;
+    /* Slot store must be visible before the head update */
+    __asm volatile ("" ::: "memory");
+    q->head = head + 1u;
+    return true;
+}
+
+/**
+ * @brief Consumer: dequeue a block.  Returns NULL if the queue is empty.
+ */
+static inline block_t *blkq_pop(blkq_t *q)
+{
+    uint32_t tail = q->tail;
+    if (q->head == tail) {
+        return NULL;
+    }
+    __asm volatile ("" ::: "memory");
+    block_t *blk = q->slot[tail & (BLOCK_QUEUE_DEPTH - 1u)];
+    __asm volatile ("" ::: "memory");
+    q->tail = tail + 1u;
+    return blk;
+}
+
+/**
+ * @brief Put every block of @p pool onto @p free_q.
+ *
+ * @return false if @p count exceeds the queue depth.
+ */
+static inline bool block_pool_init(block_t *pool, uint32_t count, blkq_t *free_q)
+{
+    if (count > BLOCK_QUEUE_DEPTH) {
+        return false;
+    }
+    blkq_init(free_q);
+    for (uint32_t i = 0u; i < count; i++) {
+        pool[i].len       = 0u;
+        pool[i].timestamp = 0u;
+        (void)blkq_push(free_q, &pool[i]);
+    }
+    return true;
+}
+
+#endif /* BLOCK_QUEUE_H */
@@ -91,6 +91,20 @@ typedef enum {
     osPriorityReserved      = 0x7FFFFFFF
 } osPriority_t;
 
+/* ---- Flags options and error codes ------------------------------------- */
+
+#define osFlagsWaitAny      0x00000000U /**< Wait for any flag (default) */
+#define osFlagsWaitAll      0x00000001U /**< Wait for all flags (not supported) */
+#define osFlagsNoClear      0x00000002U /**< Do not clear flags which have been specified to wait for */
+
+#define osFlagsError          0x80000000U /**< Error indicator */
+#define osFlagsErrorUnknown   0xFFFFFFFFU /**< osError (-1) */
+#define osFlagsErrorTimeout   0xFFFFFFFEU /**< osErrorTimeout (-2) */
+#define osFlagsErrorResource  0xFFFFFFFDU /**< osErrorResource (-3) */
+#define osFlagsErrorParameter 0xFFFFFFFCU /**< osErrorParameter (-4) */
+
+#define osWaitForever       0xFFFFFFFFU /**< Wait forever timeout value */
+
 /* ---- Opaque handle types ----------------------------------------------- */
 
 typedef void *osThreadId_t;
@@ -145,6 +159,25 @@ osThreadId_t osThreadNew(osThreadFunc_t func, void *argument,
  */
 osStatus_t osThreadYield(void);
 
+/* ---- Thread flags ------------------------------------------------------ */
+
+/**
+ * @brief  Set thread flags of a thread (task or ISR context).
+ * @param  thread_id  Thread to signal.
+ * @param  flags      Flags to set (bit 31 must be clear).
+ * @return Flags of the thread after setting, or an osFlagsError* code.
+ */
+uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags);
+
+/**
+ * @brief  Wait for any of the specified flags of the current thread.
+ * @param  flags    Flags to wait for.
+ * @param  options  osFlagsWaitAny, optionally | osFlagsNoClear.
+ * @param  timeout  Timeout in kernel ticks, 0 to poll, osWaitForever.
+ * @return Flags before clearing, or an osFlagsError* code.
+ */
+uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options, uint32_t timeout);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,56 @@
+/**
+ * @file dwt.h
+ * @brief Cortex-M7 DWT cycle counter helpers for the FT2232HL FIFO bridge.
+ *
+ * CYCCNT counts CPU cycles (480 MHz on this board) and wraps every ~8.9 s.
+ * Differences of two readings are wrap-safe as long as the measured
+ * interval is shorter than that.
+ */
+
+#ifndef DWT_H
+#define DWT_H
+
+#include "stm32h7xx.h"
+#include <stdbool.h>
+
+/** Software unlock key for the DWT Lock Access Register */
+#define DWT_LAR_UNLOCK_KEY  0xC5ACCE55u
+
+/**
+ * @brief Enable the DWT cycle counter (idempotent).
+ */
+static inline void dwt_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->LAR    = DWT_LAR_UNLOCK_KEY;
+    DWT->CYCCNT = 0u;
+    DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief Current CPU cycle count.
+ */
+static inline uint32_t dwt_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+/**
+ * @brief Busy-wait until CYCCNT reaches @p deadline (returns at once if it
+ *        already has).  Wrap-safe for deadlines within ±4.4 s of now.
+ */
+static inline void dwt_wait_until(uint32_t deadline)
+{
+    while ((int32_t)(DWT->CYCCNT - deadline) < 0) {
+    }
+}
+
+/**
+ * @brief True if CYCCNT is past @p deadline.
+ */
+static inline bool dwt_past(uint32_t deadline)
+{
+    return (int32_t)(DWT->CYCCNT - deadline) > 0;
+}
+
+#endif /* DWT_H */
@@ -0,0 +1,231 @@
+/**
+ * @file fifb.h
+ * @brief Incremental parser for the FIFB file-transfer stream that checks
+ *        its header and payload CRC32s on the fly.
+ *
+ * Stream format (PC/FifoBridge.Common/TransferProtocol.cs, little-endian):
+ *
+ *   "FIFB" magic (4), version (2), name length N (2), name (N),
+ *   file size S (8), header CRC32 (4), payload (S), payload CRC32 (4)
+ *
+ * fifb_feed() takes the stream in arbitrary pieces.  Between transfers it
+ * hunts for the magic byte by byte; inside a transfer the name and payload
+ * are handed to the CRC function in one call per piece, so a bulk payload
+ * costs one call per fifb_feed().  A transfer ends with the tracker's done
+ * callback: FIFB_BAD_HEADER (the size cannot be trusted, so the tracker
+ * hunts for the next magic) or the payload verdict.  A header damaged in
+ * its magic or version is not recognised at all; its bytes, like any
+ * others outside a transfer, are counted in skipped.
+ *
+ * The CRC is supplied by the caller as a running-CRC update (reflected
+ * ISO 3309 polynomial, not finalised), so the same parser runs on the CRC
+ * peripheral on target and on fifb_crc32_sw() in host tools.  A tracker
+ * that only needs the framing sets hdr_only: the header CRC is still
+ * checked (it is what makes the file size trustworthy), the payload is
+ * skipped in O(1) per piece and always reported FIFB_OK.
+ */
+
+#ifndef FIFB_H
+#define FIFB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define FIFB_MAGIC     0x46494642u  /* "FIFB" as a little-endian uint32 */
+#define FIFB_VERSION   1u
+#define FIFB_CRC_INIT  0xFFFFFFFFu  /* initial value and final XOR */
+
+/** Running CRC32 update over @p len bytes; returns the new running CRC */
+typedef uint32_t (*fifb_crc_fn)(uint32_t crc, const uint8_t *p,
+                                uint32_t len);
+
+typedef enum {
+    FIFB_OK = 0,
+    FIFB_BAD_HEADER,   /**< Header CRC32 mismatch */
+    FIFB_BAD_PAYLOAD,  /**< Trailer does not match the payload CRC32 */
+} fifb_result_t;
+
+/* Parser states: the magic hunt, then one per field */
+enum {
+    FIFB_S_MAGIC = 0,
+    FIFB_S_VERSION,
+    FIFB_S_NAMELEN,
+    FIFB_S_NAME,
+    FIFB_S_SIZE,
+    FIFB_S_HDRCRC,
+    FIFB_S_PAYLOAD,
+    FIFB_S_TRAILER,
+};
+
+typedef struct fifb_tracker fifb_tracker_t;
+
+/** Called once per transfer, after its header CRC or its trailer (optional) */
+typedef void (*fifb_done_fn)(fifb_tracker_t *t, fifb_result_t r);
+
+struct fifb_tracker {
+    fifb_crc_fn  crc_fn;
+    fifb_done_fn done;
+    bool         hdr_only; /**< Skip the payload CRC (framing only) */
+    uint32_t     state;
+    uint32_t     magic;    /**< Last four bytes while hunting */
+    uint64_t     left;     /**< Bytes left in the current field */
+    uint64_t     value;    /**< Current field so far (fields ≤ 8 bytes) */
+    uint32_t     pos;      /**< Bytes of the current field seen */
+    uint32_t     crc;      /**< Running CRC of the header or payload */
+    uint64_t     size;     /**< File size of the current transfer */
+    uint32_t     seq;      /**< Headers seen, i.e. number of this transfer */
+    uint64_t     skipped;  /**< Bytes outside any recognised transfer */
+};
+
+/* ---- Software CRC -------------------------------------------------- */
+
+/**
+ * @brief Bitwise running CRC32 (ISO 3309, reflected), for host tools and
+ *        tests.  Same results as TransferProtocol.Crc32Update().
+ */
+static inline uint32_t fifb_crc32_sw(uint32_t crc, const uint8_t *p,
+                                     uint32_t len)
+{
+    for (uint32_t i = 0u; i < len; i++) {
+        crc ^= p[i];
+        for (uint32_t k = 0u; k < 8u; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return crc;
+}
+
+/* ---- Parser -------------------------------------------------------- */
+
+static inline void fifb_report(fifb_tracker_t *t, fifb_result_t r)
+{
+    if (t->done != NULL) {
+        t->done(t, r);
+    }
+}
+
+static inline void fifb_init(fifb_tracker_t *t, fifb_crc_fn crc_fn,
+                             fifb_done_fn done)
+{
+    *t = (fifb_tracker_t){ .crc_fn = crc_fn, .done = done,
+                           .state = FIFB_S_MAGIC };
+}
+
+static inline void fifb_enter(fifb_tracker_t *t, uint32_t state,
+                              uint64_t len)
+{
+    t->state = state;
+    t->left  = len;
+    t->value = 0u;
+    t->pos   = 0u;
+}
+
+/**
+ * @brief Act on a completed field and move to the next one.
+ */
+static inline void fifb_next(fifb_tracker_t *t)
+{
+    switch (t->state) {
+    case FIFB_S_VERSION:
+        if (t->value == FIFB_VERSION) {
+            fifb_enter(t, FIFB_S_NAMELEN, 2u);
+        } else {
+            t->state    = FIFB_S_MAGIC;  /* not a header we know */
+            t->skipped += 6u;
+        }
+        break;
+    case FIFB_S_NAMELEN:
+        fifb_enter(t, FIFB_S_NAME, t->value);
+        break;
+    case FIFB_S_NAME:
+        fifb_enter(t, FIFB_S_SIZE, 8u);
+        break;
+    case FIFB_S_SIZE:
+        t->size = t->value;
+        fifb_enter(t, FIFB_S_HDRCRC, 4u);
+        break;
+    case FIFB_S_HDRCRC:
+        t->seq++;
+        if ((uint32_t)t->value != (t->crc ^ FIFB_CRC_INIT)) {
+            t->state = FIFB_S_MAGIC;
+            fifb_report(t, FIFB_BAD_HEADER);
+        } else {
+            t->crc = FIFB_CRC_INIT;
+            fifb_enter(t, FIFB_S_PAYLOAD, t->size);
+        }
+        break;
+    case FIFB_S_PAYLOAD:
+        fifb_enter(t, FIFB_S_TRAILER, 4u);
+        break;
+    default:  /* FIFB_S_TRAILER */
+        t->state = FIFB_S_MAGIC;
+        fifb_report(t, (t->hdr_only ||
+                        (uint32_t)t->value == (t->crc ^ FIFB_CRC_INIT))
+                           ? FIFB_OK : FIFB_BAD_PAYLOAD);
+        break;
+    }
+}
+
+/**
+ * @brief True between transfers: no header, payload or trailer is open and
+ *        the bytes fed so far do not end in the first bytes of a magic.
+ *        Something else can be spliced into the stream at this point.
+ */
+static inline bool fifb_idle(const fifb_tracker_t *t)
+{
+    if (t->state != FIFB_S_MAGIC) {
+        return false;
+    }
+    for (uint32_t k = 1u; k < 4u; k++) {
+        uint32_t head = FIFB_MAGIC & ((1u << (8u * k)) - 1u);
+        if ((t->magic >> (32u - 8u * k)) == head) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Feed the next @p len bytes of the stream.
+ */
+static inline void fifb_feed(fifb_tracker_t *t, const uint8_t *p,
+                             uint32_t len)
+{
+    static const uint8_t magic[4] = { 0x42u, 0x46u, 0x49u, 0x46u };
+
+    while (len != 0u) {
+        if (t->state == FIFB_S_MAGIC) {
+            t->magic = (t->magic >> 8) | ((uint32_t)*p++ << 24);
+            len--;
+            t->skipped++;
+            if (t->magic == FIFB_MAGIC) {
+                t->magic    = 0u;
+                t->skipped -= 4u;
+                t->crc      = t->crc_fn(FIFB_CRC_INIT, magic, 4u);
+                fifb_enter(t, FIFB_S_VERSION, 2u);
+            }
+            continue;
+        }
+
+        uint32_t n = (t->left < len) ? (uint32_t)t->left : len;
+        if (t->state == FIFB_S_PAYLOAD ? !t->hdr_only
+                                       : (t->state != FIFB_S_HDRCRC &&
+                                          t->state != FIFB_S_TRAILER)) {
+            t->crc = t->crc_fn(t->crc, p, n);
+        }
+        if (t->state != FIFB_S_NAME && t->state != FIFB_S_PAYLOAD) {
+            for (uint32_t i = 0u; i < n; i++) {
+                t->value |= (uint64_t)p[i] << (8u * t->pos++);
+            }
+        }
+        p       += n;
+        len     -= n;
+        t->left -= n;
+        if (t->left == 0u) {
+            fifb_next(t);
+        }
+    }
+}
+
+#endif /* FIFB_H */
@@ -10,18 +10,20 @@
  *    RXF#  (input)     : PC0   – low = data available
  *    TXE#  (input)     : PC1   – low = transmit buffer NOT full
  *    RD#   (output)    : PC2   – pull low to clock a byte out
- *    WR#   (output)    : PC3   – not used in read-only direction (keep high)
+ *    WR#   (output)    : PC3   – reverse channel writes (else kept high)
  *    CLKOUT(input)     : PC4   – 60 MHz bus clock from FT2232HL
  *    OE#   (output)    : PC5   – pull low to enable output drivers
  *
  *  FIFO#2 (MCU -> PC Receiver) – "write" side
  *    Data bus (output) : PF0..PF7
- *    RXF#  (input)     : PD0   – optional: low = FT2232HL has data for us
+ *    RXF#  (input)     : PD0   – reverse channel: low = data for us
  *    TXE#  (input)     : PD1   – low = transmit buffer NOT full (we can write)
- *    RD#   (output)    : PD2   – optional
+ *    RD#   (output)    : PD2   – reverse channel reads (else kept high)
  *    WR#   (output)    : PD3   – pull low then high to clock a byte in
- *    CLKOUT(input)     : PD4   – optional: 60 MHz clock
- *    OE#   (output)    : PD5   – optional
+ *    CLKOUT(input)     : PD4   – 60 MHz bus clock from FT2232HL
+ *    OE#   (output)    : PD5   – reverse channel reads (else kept high)
+ *
+ *  With BRIDGE_REVERSE both data buses carry bytes in both directions.
  */
 
 #ifndef FIFO_BRIDGE_H
@@ -29,6 +31,9 @@
 
 #include "stm32h7xx_hal.h"
 #include "ring_buffer.h"
+#include "block_queue.h"
+#include "cmsis_os.h"
+#include "tcm.h"
 
 /* ---- Port/pin definitions ------------------------------------------ */
 
@@ -41,7 +46,7 @@
 #define FIFO1_RXF_PIN     GPIO_PIN_0   /* input  – active low */
 #define FIFO1_TXE_PIN     GPIO_PIN_1   /* input  – active low */
 #define FIFO1_RD_PIN      GPIO_PIN_2   /* output – active low */
-#define FIFO1_WR_PIN      GPIO_PIN_3   /* output – active low (unused here) */
+#define FIFO1_WR_PIN      GPIO_PIN_3   /* output – active low (reverse only) */
 #define FIFO1_CLKOUT_PIN  GPIO_PIN_4   /* input  – 60 MHz */
 #define FIFO1_OE_PIN      GPIO_PIN_5   /* output – active low */
 
@@ -51,23 +56,42 @@
 
 /* FIFO#2 control – GPIOD */
 #define FIFO2_CTRL_PORT   GPIOD
-#define FIFO2_RXF_PIN     GPIO_PIN_0   /* input  – optional */
+#define FIFO2_RXF_PIN     GPIO_PIN_0   /* input  – active low (reverse only) */
 #define FIFO2_TXE_PIN     GPIO_PIN_1   /* input  – active low */
-#define FIFO2_RD_PIN      GPIO_PIN_2   /* output – optional */
+#define FIFO2_RD_PIN      GPIO_PIN_2   /* output – active low (reverse only) */
 #define FIFO2_WR_PIN      GPIO_PIN_3   /* output – active low */
-#define FIFO2_CLKOUT_PIN  GPIO_PIN_4   /* input  – optional */
-#define FIFO2_OE_PIN      GPIO_PIN_5   /* output – optional */
+#define FIFO2_CLKOUT_PIN  GPIO_PIN_4   /* input  – 60 MHz */
+#define FIFO2_OE_PIN      GPIO_PIN_5   /* output – active low (reverse only) */
 
 /* ---- Direct-register helper macros --------------------------------- */
 
 /** Read FIFO#1 data byte from PE[7:0] via IDR register */
 #define FIFO1_READ_DATA()   ((uint8_t)(FIFO1_DATA_PORT->IDR & FIFO1_DATA_MASK))
 
+/** PF[7:0] BSRR word that drives byte b: set the 1 bits, reset the 0 bits */
+#define FIFO2_BSRR_WORD(b) \
+    ((uint32_t)(b) | ((uint32_t)(~(b) & FIFO2_DATA_MASK) << 16))
+
+/**
+ * Set BRIDGE_BSRR_LUT to 0 to compute FIFO2_BSRR_WORD() for every byte
+ * instead of loading it from g_fifo2_bsrr_lut[] (fifo_bsrr.c).
+ */
+#ifndef BRIDGE_BSRR_LUT
+#define BRIDGE_BSRR_LUT   1
+#endif
+
+#if BRIDGE_BSRR_LUT
+/** FIFO2_BSRR_WORD() of every byte value, in DTCM with BRIDGE_DTCM_DATA */
+extern const uint32_t g_fifo2_bsrr_lut[256];
+#define FIFO2_BSRR(b)     (g_fifo2_bsrr_lut[(uint8_t)(b)])
+#else
+#define FIFO2_BSRR(b)     FIFO2_BSRR_WORD((uint8_t)(b))
+#endif
+
 /** Write byte to FIFO#2 via PF[7:0] BSRR (atomic set/reset) */
 #define FIFO2_WRITE_DATA(b) \
     do { \
-        FIFO2_DATA_PORT->BSRR = (uint32_t)(b) | \
-                                 ((uint32_t)(~(b) & FIFO2_DATA_MASK) << 16); \
+        FIFO2_DATA_PORT->BSRR = FIFO2_BSRR(b); \
     } while (0)
 
 /** Read FIFO#1 RXF# signal (active low: 0 = data ready) */
@@ -76,6 +100,10 @@
 /** Read FIFO#2 TXE# signal (active low: 0 = can write) */
 #define FIFO2_TXE_ACTIVE()  (!(FIFO2_CTRL_PORT->IDR & FIFO2_TXE_PIN))
 
+/** Reverse channel: FIFO#2 RXF# / FIFO#1 TXE# (active low) */
+#define FIFO2_RXF_ACTIVE()  (!(FIFO2_CTRL_PORT->IDR & FIFO2_RXF_PIN))
+#define FIFO1_TXE_ACTIVE()  (!(FIFO1_CTRL_PORT->IDR & FIFO1_TXE_PIN))
+
 /** Assert FIFO#1 OE# (enable output drivers before read burst) */
 #define FIFO1_OE_ASSERT()   (FIFO1_CTRL_PORT->BSRR = (uint32_t)FIFO1_OE_PIN  << 16)
 #define FIFO1_OE_DEASSERT() (FIFO1_CTRL_PORT->BSRR = FIFO1_OE_PIN)
@@ -88,11 +116,242 @@
 #define FIFO2_WR_ASSERT()   (FIFO2_CTRL_PORT->BSRR = (uint32_t)FIFO2_WR_PIN  << 16)
 #define FIFO2_WR_DEASSERT() (FIFO2_CTRL_PORT->BSRR = FIFO2_WR_PIN)
 
-/* ---- Shared ring buffer -------------------------------------------- */
+/** Deassert FIFO#2 OE# (reverse reads assert it, see fifo_strobe.h) */
+#define FIFO2_OE_DEASSERT() (FIFO2_CTRL_PORT->BSRR = FIFO2_OE_PIN)
+
+/* ---- Buffer sizing ------------------------------------------------- */
+
+/**
+ * Size of the bridge ring buffer storage (power of two).  256 KB drains in
+ * several milliseconds at full FT2232H rate, enough to ride out the USB
+ * scheduling gaps of the receiving PC.  Override with -DBRIDGE_BUF_SIZE=...
+ * It is also the largest size that links: 512 KB would take all of
+ * AXI-SRAM, which .data, .bss, heap and stacks share.
+ */
+#ifndef BRIDGE_BUF_SIZE
+#define BRIDGE_BUF_SIZE   (256u * 1024u)
+#endif
+
+/** Upper bound on bytes moved between two head/tail updates */
+#ifndef BRIDGE_BURST_LEN
+#define BRIDGE_BURST_LEN  64u
+#endif
+
+#if BRIDGE_DTCM_BUF && (BRIDGE_BUF_SIZE > 64u * 1024u)
+#error "BRIDGE_DTCM_BUF: BRIDGE_BUF_SIZE must be <= 64 KB to fit in DTCM"
+#endif
+
+/* ---- Block pipeline (alternative to the byte ring) ----------------- */
+
+/**
+ * Set BRIDGE_USE_BLOCKS to 1 to pass fixed-size blocks (BLOCK_DATA_SIZE
+ * bytes, see block_queue.h) between the tasks by pointer instead of
+ * streaming bytes through g_bridge_buf.  The pool takes as many whole
+ * blocks as fit in BRIDGE_BUF_SIZE.  A block_t is 2080 bytes with its
+ * header and padding, so the default is 126 blocks (262,080 bytes).
+ */
+#ifndef BRIDGE_USE_BLOCKS
+#define BRIDGE_USE_BLOCKS   0
+#endif
+
+#define BRIDGE_BLOCK_COUNT  ((uint32_t)(BRIDGE_BUF_SIZE / sizeof(block_t)))
+
+#if BRIDGE_USE_BLOCKS
+_Static_assert(BRIDGE_BLOCK_COUNT <= BLOCK_QUEUE_DEPTH,
+               "BRIDGE_BLOCK_COUNT exceeds BLOCK_QUEUE_DEPTH");
+#endif
+
+/* ---- DMA legs -------------------------------------------------------- */
+
+/**
+ * Set BRIDGE_READER_DMA to 1 to let TIM2 + DMA1 strobe RD# and capture
+ * PE[7:0] into the ring buffer (see fifo_dma.h); ReaderTask then only
+ * arms chunks and commits them.  Byte-ring mode only.
+ */
+#ifndef BRIDGE_READER_DMA
+#define BRIDGE_READER_DMA   0
+#endif
+
+/**
+ * Set BRIDGE_WRITER_DMA to 1 to let TIM8 + DMA1 drive PF[7:0] and strobe
+ * WR# from a staging array of BSRR words; WriterTask then only stages
+ * chunks and releases what FIFO#2 accepted.  Byte-ring mode only.
+ */
+#ifndef BRIDGE_WRITER_DMA
+#define BRIDGE_WRITER_DMA   0
+#endif
+
+#if (BRIDGE_READER_DMA || BRIDGE_WRITER_DMA) && BRIDGE_USE_BLOCKS
+#error "BRIDGE_READER_DMA / BRIDGE_WRITER_DMA require the byte ring (BRIDGE_USE_BLOCKS=0)"
+#endif
+
+#if BRIDGE_READER_DMA && BRIDGE_DTCM_BUF
+#error "BRIDGE_READER_DMA cannot write a ring buffer in DTCM (BRIDGE_DTCM_BUF)"
+#endif
+
+/* ---- Reverse channel ----------------------------------------------- */
+
+/**
+ * Set BRIDGE_REVERSE to 1 to also bridge FIFO#2 → FIFO#1 (Receiver PC →
+ * Sender PC) through its own ring buffer, g_rev_buf, with RevReaderTask and
+ * RevWriterTask (fifo_reverse.c).  Meant for acknowledgements and flow
+ * control credits.  CPU strobes only: the strobe loops turn each shared
+ * data bus around per burst.
+ */
+#ifndef BRIDGE_REVERSE
+#define BRIDGE_REVERSE       0
+#endif
+
+/** Reverse ring buffer size (power of two) */
+#ifndef BRIDGE_REV_BUF_SIZE
+#define BRIDGE_REV_BUF_SIZE  (4u * 1024u)
+#endif
+
+/**
+ * Kernel ticks a reverse task sleeps when its FIFO is idle.  PD0 and PC1
+ * share EXTI lines with PC0 and PD1, so these pins are polled.
+ */
+#ifndef BRIDGE_REV_POLL
+#define BRIDGE_REV_POLL      1u
+#endif
+
+#if BRIDGE_REVERSE && (BRIDGE_READER_DMA || BRIDGE_WRITER_DMA)
+#error "BRIDGE_REVERSE requires CPU strobes on both legs (no BRIDGE_*_DMA)"
+#endif
+
+/* ---- Single pump task ---------------------------------------------- */
+
+/**
+ * Set BRIDGE_SINGLE_TASK to 1 to replace ReaderTask and WriterTask with one
+ * BridgeTask that alternates a bounded read burst from FIFO#1 and a bounded
+ * write burst to FIFO#2 in the same loop.  The ring buffer stays, but no
+ * thread flag or context switch is needed to hand bytes from one leg to
+ * the other.  CPU legs of the byte ring only.
+ */
+#ifndef BRIDGE_SINGLE_TASK
+#define BRIDGE_SINGLE_TASK  0
+#endif
+
+#if BRIDGE_SINGLE_TASK && \
+    (BRIDGE_USE_BLOCKS || BRIDGE_READER_DMA || BRIDGE_WRITER_DMA)
+#error "BRIDGE_SINGLE_TASK requires the byte ring with CPU strobes on both legs"
+#endif
+
+/* ---- Burst profiling -------------------------------------------------- */
+
+/**
+ * Set BRIDGE_PERF to 1 to time every CPU burst of the byte ring with the
+ * DWT (g_bridge_perf).  Used to compare BRIDGE_SINGLE_TASK against the
+ * two-task design on the same board; costs two CYCCNT reads per burst.
+ */
+#ifndef BRIDGE_PERF
+#define BRIDGE_PERF  0
+#endif
+
+#if BRIDGE_PERF && (BRIDGE_USE_BLOCKS || BRIDGE_READER_DMA || BRIDGE_WRITER_DMA)
+#error "BRIDGE_PERF times the CPU legs of the byte ring only"
+#endif
+
+/**
+ * Per-leg burst timing.  A "gap" is the time from the end of a burst that
+ * hit its length limit (so the leg had more work) to the start of that
+ * leg's next burst: the other leg's burst plus whatever scheduling sits
+ * between them.
+ */
+typedef struct {
+    uint64_t bytes;      /**< Bytes moved */
+    uint64_t cycles;     /**< Cycles from first to last burst end */
+    uint64_t busy;       /**< Cycles spent inside bursts */
+    uint64_t gap_sum;    /**< Sum of all gaps */
+    uint32_t gap_max;    /**< Longest gap */
+    uint32_t gaps;       /**< Gaps measured */
+    uint32_t bursts;     /**< Bursts that moved at least one byte */
+    uint32_t last_end;   /**< CYCCNT at the end of the previous burst */
+    bool     last_full;  /**< Previous burst hit its length limit */
+} bridge_leg_perf_t;
+
+typedef struct {
+    bridge_leg_perf_t leg[2];  /**< [0] FIFO#1 read, [1] FIFO#2 write */
+} bridge_perf_t;
+
+#if BRIDGE_PERF
+extern bridge_perf_t g_bridge_perf;
+#endif
+
+/* ---- Flow control watermarks --------------------------------------- */
+
+/**
+ * WriterTask sleeps while the ring buffer is empty and is woken once
+ * occupancy reaches BRIDGE_WRITER_WAKE_FILL (or ReaderTask finds FIFO#1
+ * idle and flushes what it has).  ReaderTask sleeps while the ring buffer
+ * is full and is woken once occupancy drops to BRIDGE_READER_WAKE_FILL.
+ * The two act on different tasks, so neither has to be the larger one.
+ */
+#ifndef BRIDGE_WRITER_WAKE_FILL
+#define BRIDGE_WRITER_WAKE_FILL  (BRIDGE_BUF_SIZE / 64u)
+#endif
+
+#ifndef BRIDGE_READER_WAKE_FILL
+#define BRIDGE_READER_WAKE_FILL  (BRIDGE_BUF_SIZE / 2u)
+#endif
+
+_Static_assert(BRIDGE_WRITER_WAKE_FILL > 0u &&
+               BRIDGE_WRITER_WAKE_FILL < BRIDGE_BUF_SIZE,
+               "BRIDGE_WRITER_WAKE_FILL must lie inside the ring buffer");
+_Static_assert(BRIDGE_READER_WAKE_FILL > 0u &&
+               BRIDGE_READER_WAKE_FILL < BRIDGE_BUF_SIZE,
+               "BRIDGE_READER_WAKE_FILL must lie inside the ring buffer");
+
+/** Thread flags used for the watermark / block-available notifications */
+#define BRIDGE_FLAG_DATA   0x0001u  /**< to WriterTask: data ready */
+#define BRIDGE_FLAG_SPACE  0x0002u  /**< to ReaderTask: space ready */
+#define BRIDGE_FLAG_DMA    0x0004u  /**< to either task: DMA chunk done / FIFO stalled */
+#define BRIDGE_FLAG_FIFO   0x0008u  /**< to either task: RXF# / TXE# edge (fifo_exti.c) */
+
+/**
+ * Block pipeline latency, measured by WriterTask for every block: DWT
+ * cycles from ReaderTask sampling the block's first byte to WriterTask
+ * starting the burst that drives it into FIFO#2.
+ */
+typedef struct {
+    uint64_t sum;     /**< Sum over all blocks */
+    uint32_t max;     /**< Longest */
+    uint32_t last;    /**< Most recent block */
+    uint32_t blocks;  /**< Blocks measured */
+} block_latency_t;
+
+/* ---- Shared ring buffer / block queues ----------------------------- */
+#if BRIDGE_USE_BLOCKS
+extern blkq_t g_free_blocks;  /**< WriterTask → ReaderTask */
+extern blkq_t g_full_blocks;  /**< ReaderTask → WriterTask */
+extern block_latency_t g_block_latency;
+#else
 extern ring_buffer_t g_bridge_buf;
+#endif
+
+#if BRIDGE_REVERSE
+extern ring_buffer_t g_rev_buf;  /**< RevReaderTask → RevWriterTask */
+#endif
+
+/* ---- Task handles (set by main.c before the scheduler starts) ------ */
+extern osThreadId_t g_reader_thread;
+extern osThreadId_t g_writer_thread;
+#if BRIDGE_REVERSE
+extern osThreadId_t g_rev_reader_thread;
+extern osThreadId_t g_rev_writer_thread;
+#endif
+
+/* ---- Statistics export --------------------------------------------- */
+#if RB_ENABLE_STATS && !BRIDGE_USE_BLOCKS
+/** Snapshot of the bridge ring buffer's occupancy/pressure statistics */
+void bridge_get_buf_stats(rb_stats_t *out);
+#endif
 
 /* ---- FreeRTOS task prototypes -------------------------------------- */
 void StartReaderTask(void *argument);
 void StartWriterTask(void *argument);
+void StartBridgeTask(void *argument);
+void StartRevReaderTask(void *argument);
+void StartRevWriterTask(void *argument);
 
 #endif /* FIFO_BRIDGE_H */
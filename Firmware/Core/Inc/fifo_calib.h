@@ -0,0 +1,124 @@
+/**
+ * @file fifo_calib.h
+ * @brief Boot-time CLKOUT measurement and strobe timing calibration for the
+ *        FT2232HL 245-Sync-FIFO bridge.
+ *
+ * fifo_calibrate() runs once from main(), before the scheduler starts, and
+ * replaces the compile-time strobe timing of each CPU leg (g_fifo1_timing,
+ * g_fifo2_timing, see fifo_strobe.h) with values derived on this board:
+ *
+ *   period  CLKOUT period in CPU cycles, from DWT timestamps of CLKOUT
+ *           edges 256 periods apart, averaged over 8 spans
+ *   open    datasheet output-valid time (7.15 ns) at SystemCoreClock
+ *   setup   datasheet setup time (8 ns) at SystemCoreClock
+ *   skew    GPIO write → read-back round trip, plus the phase spread of
+ *           the edge lock measured over CALIB_SYNCS locks
+ *
+ * A leg whose CLKOUT does not toggle, or is grossly off 60 MHz, keeps the
+ * nominal period for SystemCoreClock.  A result that cannot be scheduled
+ * even with pulsed strobes is not applied: the measurement has shown the
+ * defaults to be optimistic, so the leg falls back to them with pulsed
+ * strobes (CALIB_FALLBACK_CLKS), where a missed deadline costs time rather
+ * than a byte.  g_fifo_calib keeps the skew that did not fit, and the
+ * fallback is flagged in telemetry (FIFT_FLAG_CALIB).
+ *
+ * With BRIDGE_CALIB_PRBS=1 the read leg is then tuned against a PRBS-31
+ * stream (prbs.h) sent into FIFO#1 by the PC: open is stepped down one
+ * cycle at a time until bit errors appear, then backed off by
+ * CALIB_PRBS_BACKOFF above the last clean step.  The write leg cannot be
+ * checked from the MCU side and keeps its derived timing.
+ */
+
+#ifndef FIFO_CALIB_H
+#define FIFO_CALIB_H
+
+#include "fifo_strobe.h"
+
+/* ---- Configuration -------------------------------------------------- */
+
+/** Set to 0 to skip calibration and run on the STROBE_* defaults */
+#ifndef BRIDGE_CALIBRATE
+#define BRIDGE_CALIBRATE       1
+#endif
+
+/** FT2232H CLKOUT in 245 synchronous FIFO mode */
+#define FT_CLKOUT_HZ           60000000u
+
+/** FT2232H datasheet: CLKOUT → RXF#/TXE#/data valid, max (ps) */
+#define FT_T_VALID_PS          7150u
+
+/** FT2232H datasheet: RD#/WR#/data setup to CLKOUT, min (ps) */
+#define FT_T_SETUP_PS          8000u
+
+/** Edge locks used to measure the phase spread */
+#ifndef CALIB_SYNCS
+#define CALIB_SYNCS            32u
+#endif
+
+/** GPIO round trips measured (worst one is kept) */
+#ifndef CALIB_ROUNDTRIPS
+#define CALIB_ROUNDTRIPS       16u
+#endif
+
+/** CLKOUT periods per byte on a leg whose derived timing does not fit */
+#ifndef CALIB_FALLBACK_CLKS
+#define CALIB_FALLBACK_CLKS    4u
+#endif
+
+_Static_assert(CALIB_FALLBACK_CLKS >= 2u,
+               "CALIB_FALLBACK_CLKS must select pulsed strobes");
+
+/** Run the PRBS-31 margin search on the read leg */
+#ifndef BRIDGE_CALIB_PRBS
+#define BRIDGE_CALIB_PRBS      0
+#endif
+
+/** Bytes checked per margin step */
+#ifndef CALIB_PRBS_BYTES
+#define CALIB_PRBS_BYTES       4096u
+#endif
+
+/** Give up on the PRBS search if the PC sends nothing for this long */
+#ifndef CALIB_PRBS_TIMEOUT_MS
+#define CALIB_PRBS_TIMEOUT_MS  2000u
+#endif
+
+/** Cycles added back above the lowest error-free open */
+#ifndef CALIB_PRBS_BACKOFF
+#define CALIB_PRBS_BACKOFF     1u
+#endif
+
+/* ---- Results -------------------------------------------------------- */
+
+typedef struct {
+    bool     clk_ok;     /**< CLKOUT toggled at a plausible rate */
+    bool     applied;    /**< Derived timing fits and is in use */
+    bool     fallback;   /**< It does not: pulsed defaults in use */
+    uint32_t skew;       /**< Derived skew, cycles (too large if fallback) */
+    uint32_t period_q8;  /**< Measured CPU cycles per CLKOUT, × 256 */
+    uint32_t clk_hz;     /**< CLKOUT frequency implied by period_q8 */
+    uint32_t spread_q8;  /**< Edge lock phase spread, cycles × 256 */
+} fifo_calib_leg_t;
+
+typedef struct {
+    uint32_t         roundtrip;    /**< GPIO write → IDR read-back, cycles */
+    fifo_calib_leg_t leg[2];       /**< [0] FIFO#1 read, [1] FIFO#2 write */
+    bool             prbs_run;     /**< A PRBS stream was seen on FIFO#1 */
+    uint32_t         prbs_open;    /**< Lowest error-free open found */
+    uint32_t         prbs_errors;  /**< Bit errors at the first failing step */
+} fifo_calib_t;
+
+extern fifo_calib_t g_fifo_calib;
+
+/* ---- API ------------------------------------------------------------ */
+
+/**
+ * @brief Measure CLKOUT on each CPU leg and update its strobe timing.
+ *
+ * Call once after MX_GPIO_Init() and dwt_init(), before osKernelStart().
+ * Takes well under a millisecond, plus up to a few seconds for the PRBS
+ * search when BRIDGE_CALIB_PRBS is set.
+ */
+void fifo_calibrate(void);
+
+#endif /* FIFO_CALIB_H */
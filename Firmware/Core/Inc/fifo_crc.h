@@ -0,0 +1,95 @@
+/**
+ * @file fifo_crc.h
+ * @brief Hardware CRC32 check of the FIFB transfers passing through the
+ *        bridge (BRIDGE_CRC=1).
+ *
+ * Two fifb.h trackers follow the forward stream: one over the bytes as
+ * they arrive from FIFO#1 (fifo_crc_rx(), called after each read burst),
+ * one over the bytes as they leave for FIFO#2 (fifo_crc_tx(), called after
+ * each write burst).  Both run their CRCs on the STM32H7 CRC unit, set up
+ * for the same polynomial as TransferProtocol.Crc32 (0x04C11DB7 reflected,
+ * init and final XOR 0xFFFFFFFF).  The unit is shared: every update loads
+ * the tracker's running CRC into CRC->INIT, so the two tasks can take turns
+ * without disturbing each other.
+ *
+ * The verdicts tell where a corrupted transfer was damaged:
+ *
+ *   rx bad                       sender PC, its FT2232H or the FIFO#1 leg
+ *   rx ok,  tx bad               inside the bridge (ring buffer / blocks)
+ *   rx ok,  tx ok,  PC CRC bad   FIFO#2 leg, its FT2232H or receiver PC
+ *
+ * Nothing is held back: the checks run on bytes that have already been
+ * received or sent, so forwarding is never delayed by more than the CRC
+ * writes themselves (one 32-bit write per four bytes).
+ */
+
+#ifndef FIFO_CRC_H
+#define FIFO_CRC_H
+
+#include "fifo_bridge.h"
+#include "fifb.h"
+
+/* ---- Configuration -------------------------------------------------- */
+
+/** Set to 1 to check FIFB transfers with the CRC unit */
+#ifndef BRIDGE_CRC
+#define BRIDGE_CRC     0
+#endif
+
+/** Transfers kept in g_fifo_crc.log[] (power of two) */
+#ifndef FIFO_CRC_LOG
+#define FIFO_CRC_LOG   16u
+#endif
+
+/* ---- Results -------------------------------------------------------- */
+
+#define FIFO_CRC_PENDING  0xFFu  /**< tx verdict not in yet */
+
+typedef struct {
+    uint32_t seq;   /**< Transfer number (headers seen on FIFO#1), from 1 */
+    uint64_t size;  /**< FileSize from the header (0 if the header is bad) */
+    uint8_t  rx;    /**< fifb_result_t of the bytes received from FIFO#1 */
+    uint8_t  tx;    /**< fifb_result_t of the bytes sent to FIFO#2 */
+} fifo_crc_xfer_t;
+
+typedef struct {
+    uint32_t ok;           /**< Transfers with both CRCs intact */
+    uint32_t bad_header;   /**< Transfers with a bad header CRC */
+    uint32_t bad_payload;  /**< Transfers with a bad payload CRC */
+} fifo_crc_leg_t;
+
+typedef struct {
+    fifo_crc_leg_t  leg[2];             /**< [0] FIFO#1 in, [1] FIFO#2 out */
+    fifo_crc_xfer_t log[FIFO_CRC_LOG];  /**< Last transfers, by seq */
+    fifb_tracker_t  trk[2];             /**< Parsers (see trk[i].skipped) */
+} fifo_crc_t;
+
+/* ---- API ------------------------------------------------------------ */
+
+#if BRIDGE_CRC
+extern fifo_crc_t g_fifo_crc;
+
+/**
+ * @brief Enable and configure the CRC unit and reset both trackers.
+ *        Call once before the scheduler starts.
+ */
+void fifo_crc_init(void);
+
+/** @brief Check @p len bytes just received from FIFO#1 */
+void fifo_crc_rx(const uint8_t *p, uint32_t len);
+
+/** @brief Check @p len bytes just accepted by FIFO#2 */
+void fifo_crc_tx(const uint8_t *p, uint32_t len);
+#else
+static inline void fifo_crc_rx(const uint8_t *p, uint32_t len)
+{
+    (void)p; (void)len;
+}
+
+static inline void fifo_crc_tx(const uint8_t *p, uint32_t len)
+{
+    (void)p; (void)len;
+}
+#endif /* BRIDGE_CRC */
+
+#endif /* FIFO_CRC_H */
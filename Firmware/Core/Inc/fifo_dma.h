@@ -0,0 +1,250 @@
+/**
+ * @file fifo_dma.h
+ * @brief Timer-paced DMA engines for the FT2232HL 245-Sync-FIFO bridge on
+ *        STM32H750: FIFO#1 read leg (BRIDGE_READER_DMA=1) and FIFO#2 write
+ *        leg (BRIDGE_WRITER_DMA=1).
+ *
+ * Read leg: TIM2 is started by every rising edge of FIFO#1 CLKOUT, which is
+ * also wired to PA5 (TIM2_ETR), and runs one strobe period at the timer
+ * clock (240 MHz) in one-pulse mode.  Its four compare events therefore sit
+ * at fixed offsets from a CLKOUT edge (±1 tick of ETR resynchronisation)
+ * instead of drifting across it.  Each one triggers a DMA1 stream through
+ * DMAMUX1, so the whole RD# cycle is executed by the DMA controller:
+ *
+ *   CC1  DMA1_Stream0   GPIOC->IDR  → status[]   sample RXF# (strobe valid?)
+ *   CC2  DMA1_Stream1   rd_low      → GPIOC->BSRR   RD# low
+ *   CC3  DMA1_Stream2   GPIOE->IDR  → ring buffer   sample D[7:0]
+ *   CC4  DMA1_Stream3   rd_high     → GPIOC->BSRR   RD# high
+ *
+ *   tick    0   4   8   12  16  20  24  28  32
+ *   CLKOUT  ‾‾__‾‾__‾‾__‾‾__‾‾__‾‾__‾‾__‾‾__‾‾
+ *   RD#     ‾‾‾‾‾‾___‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+ *           ^start  ^consuming edge       ^end
+ *
+ * RD# is low for less than one CLKOUT period, so it spans exactly one
+ * rising edge once its phase is set (FIFO1_DMA_RD_LOW_AT).  RXF# and the
+ * data are sampled right after RD# falls, in the CLKOUT period that ends
+ * with the consuming edge.  The FT2232H only changes them just after a
+ * rising edge (fifo_strobe.h), so the samples match what it sees at that
+ * edge.
+ *
+ * RXF# (PC0) gates the trigger through EXTI0: a falling edge (data
+ * available) lets CLKOUT start periods, a rising edge (FIFO empty) stops
+ * that, and the period already running completes.  A strobe is therefore
+ * never cut in half.  Periods that start after RXF# went high but before
+ * the EXTI0 handler ran are recognised by their CC1 status sample and
+ * dropped by the CPU, which compacts the captured bytes before publishing
+ * them.
+ *
+ * Write leg: TIM8 and DMA1 streams 4..7 mirror the same scheme, with
+ * FIFO#2 CLKOUT also wired to PA0 (TIM8_ETR):
+ *
+ *   CC1  DMA1_Stream4   stage[]     → GPIOF->BSRR   drive D[7:0]
+ *   CC2  DMA1_Stream5   GPIOD->IDR  → status[]      sample TXE# (accepted?)
+ *   CC3  DMA1_Stream6   wr_low      → GPIOD->BSRR   WR# low
+ *   CC4  DMA1_Stream7   wr_high     → GPIOD->BSRR   WR# high
+ *
+ * stage[] holds one precomputed BSRR word per byte, copied from
+ * g_fifo2_bsrr_lut[] (FIFO2_BSRR()).  The data goes out just before WR#
+ * falls, and TXE# is sampled just after, in the CLKOUT period that ends
+ * with the accepting edge.  As for RXF#, that sample is the TXE# level the
+ * FT2232H sees at the edge.
+ * TXE# (PD1) gates TIM8 through EXTI1 the same way RXF# gates TIM2, except
+ * that a chunk stopped by TXE# is not resumed: it ends, and the bytes from
+ * the first strobe the FT2232H ignored onward are handed back unsent.
+ *
+ * The CPU only arms a chunk, sleeps, and commits/releases the result.
+ * That frees the CPU but costs throughput: with four DMA transfers per
+ * byte, either leg runs at 7.5 MB/s at most, against one byte per CLKOUT
+ * (60 MB/s) for the CPU strobe loops.
+ */
+
+#ifndef FIFO_DMA_H
+#define FIFO_DMA_H
+
+#include <stdint.h>
+
+/* ---- Strobe timing (TIM2 ticks at 240 MHz, ≈4.17 ns) -------------- */
+
+/** Timer ticks per FT2232H CLKOUT period (240 MHz / 60 MHz) */
+#define FIFO_DMA_TICKS_PER_CLKOUT  4u
+
+/**
+ * One strobe period, counted from the CLKOUT edge that started it.  The
+ * timer has to be stopped again before the edge that starts the next one,
+ * so the period ends half a CLKOUT period before an edge, which absorbs the
+ * ETR jitter.  30 ticks put the strobes 8 CLKOUT periods apart (133 ns,
+ * 7.5 MB/s); four DMA transfers to/from AHB4 GPIO must fit in that.  This
+ * caps the DMA read leg at one eighth of the CPU strobe loop, which moves
+ * one byte per CLKOUT (fifo_strobe.h).
+ */
+#ifndef FIFO1_DMA_PERIOD
+#define FIFO1_DMA_PERIOD       30u
+#endif
+
+/**
+ * CC2: RD# falls.  This sets the phase of the strobe and has to be checked
+ * once on a scope: RD# should fall about 2 ticks (≥ 8 ns, t9) before a
+ * rising CLKOUT edge.  DMA latency delays every transfer about the same,
+ * so the other events follow when only this one is moved.
+ */
+#ifndef FIFO1_DMA_RD_LOW_AT
+#define FIFO1_DMA_RD_LOW_AT    2u
+#endif
+
+/**
+ * CC1: RXF# sample.  Requested together with RD# low; the strobe streams
+ * have the higher DMA priority, so it lands just after RD# falls.
+ */
+#ifndef FIFO1_DMA_STATUS_AT
+#define FIFO1_DMA_STATUS_AT    2u
+#endif
+
+/** CC3: data sample, also just after RD# falls */
+#ifndef FIFO1_DMA_SAMPLE_AT
+#define FIFO1_DMA_SAMPLE_AT    2u
+#endif
+
+/** CC4: RD# rises, just after the consuming edge and before the next one */
+#ifndef FIFO1_DMA_RD_HIGH_AT
+#define FIFO1_DMA_RD_HIGH_AT   5u
+#endif
+
+_Static_assert(FIFO1_DMA_RD_LOW_AT <= FIFO1_DMA_STATUS_AT &&
+               FIFO1_DMA_RD_LOW_AT <= FIFO1_DMA_SAMPLE_AT &&
+               FIFO1_DMA_STATUS_AT < FIFO1_DMA_RD_HIGH_AT &&
+               FIFO1_DMA_SAMPLE_AT < FIFO1_DMA_RD_HIGH_AT &&
+               FIFO1_DMA_RD_HIGH_AT < FIFO1_DMA_PERIOD,
+               "FIFO1 DMA strobe events out of order");
+_Static_assert(FIFO1_DMA_RD_HIGH_AT - FIFO1_DMA_RD_LOW_AT <
+               FIFO_DMA_TICKS_PER_CLKOUT,
+               "RD# low must be shorter than one CLKOUT period");
+_Static_assert(FIFO1_DMA_PERIOD % FIFO_DMA_TICKS_PER_CLKOUT == 2u,
+               "FIFO1_DMA_PERIOD must end half a CLKOUT period before an edge");
+
+/** Largest number of strobes armed at once (size of the status array) */
+#ifndef FIFO1_DMA_CHUNK
+#define FIFO1_DMA_CHUNK        512u
+#endif
+
+/* ---- Write strobe timing (TIM8 ticks at 240 MHz) ------------------ */
+
+/**
+ * One write strobe period (same budget and rule as FIFO1_DMA_PERIOD).  The
+ * default caps the DMA write leg at 7.5 MB/s, one eighth of the CPU loop.
+ */
+#ifndef FIFO2_DMA_PERIOD
+#define FIFO2_DMA_PERIOD       30u
+#endif
+
+/** CC1: data word to GPIOF->BSRR, just before WR# falls */
+#ifndef FIFO2_DMA_DATA_AT
+#define FIFO2_DMA_DATA_AT      1u
+#endif
+
+/**
+ * CC3: WR# falls.  Sets the phase like FIFO1_DMA_RD_LOW_AT: on a scope,
+ * WR# should fall about 2 ticks (≥ 8 ns, t14) before a rising CLKOUT edge.
+ */
+#ifndef FIFO2_DMA_WR_LOW_AT
+#define FIFO2_DMA_WR_LOW_AT    2u
+#endif
+
+/**
+ * CC2: TXE# sample.  Requested together with WR# low, so it lands just
+ * after WR# falls and before the accepting edge.
+ */
+#ifndef FIFO2_DMA_STATUS_AT
+#define FIFO2_DMA_STATUS_AT    2u
+#endif
+
+/** CC4: WR# rises, just after the accepting edge and before the next one */
+#ifndef FIFO2_DMA_WR_HIGH_AT
+#define FIFO2_DMA_WR_HIGH_AT   5u
+#endif
+
+_Static_assert(FIFO2_DMA_DATA_AT < FIFO2_DMA_WR_LOW_AT &&
+               FIFO2_DMA_WR_LOW_AT <= FIFO2_DMA_STATUS_AT &&
+               FIFO2_DMA_STATUS_AT < FIFO2_DMA_WR_HIGH_AT &&
+               FIFO2_DMA_WR_HIGH_AT < FIFO2_DMA_PERIOD,
+               "FIFO2 DMA strobe events out of order");
+_Static_assert(FIFO2_DMA_WR_HIGH_AT - FIFO2_DMA_WR_LOW_AT <
+               FIFO_DMA_TICKS_PER_CLKOUT,
+               "WR# low must be shorter than one CLKOUT period");
+_Static_assert(FIFO2_DMA_PERIOD % FIFO_DMA_TICKS_PER_CLKOUT == 2u,
+               "FIFO2_DMA_PERIOD must end half a CLKOUT period before an edge");
+
+/** Largest number of strobes armed at once (staging: 4 bytes per byte) */
+#ifndef FIFO2_DMA_CHUNK
+#define FIFO2_DMA_CHUNK        512u
+#endif
+
+/**
+ * NVIC priority of the DMA1 stream interrupts used here (EXTI0/EXTI1 are
+ * set up by fifo_exti.c).  They set thread flags, so it must not be above
+ * configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY (i.e. numerically ≥ 5).
+ */
+#ifndef FIFO_DMA_IRQ_PRIORITY
+#define FIFO_DMA_IRQ_PRIORITY  5u
+#endif
+
+/* ---- API ---------------------------------------------------------- */
+
+/**
+ * @brief Configure TIM2 (triggered by CLKOUT on PA5), DMA1 streams 0..3
+ *        and DMAMUX1 for FIFO#1.
+ *
+ * Call once after MX_GPIO_Init() and fifo_exti_init(); the engine stays
+ * idle until fifo1_dma_read() arms it.
+ */
+void fifo1_dma_init(void);
+
+/**
+ * @brief Capture up to @p len bytes from FIFO#1 into @p dst (ReaderTask only).
+ *
+ * Blocks until @p len strobes have completed or RXF# has gone idle (0 is
+ * returned if it only blipped).  On return the bytes are compacted (invalid
+ * strobes removed) and coherent for CPU reads, and the engine is stopped.
+ *
+ * @param dst  Destination, e.g. an rb_reserve() region in AXI-SRAM (DMA1
+ *             cannot reach DTCM).
+ * @param len  Maximum bytes; clamped to FIFO1_DMA_CHUNK.
+ * @return Number of valid bytes written at @p dst.
+ */
+uint32_t fifo1_dma_read(uint8_t *dst, uint32_t len);
+
+/**
+ * @brief RXF# edge callback, run from EXTI0_IRQHandler (fifo_exti.c) when
+ *        BRIDGE_READER_DMA is set.
+ */
+void fifo1_dma_rxf_edge(void);
+
+/**
+ * @brief Configure TIM8 (triggered by CLKOUT on PA0), DMA1 streams 4..7
+ *        and DMAMUX1 for FIFO#2.
+ *
+ * Call once after MX_GPIO_Init() and fifo_exti_init(); idle until
+ * fifo2_dma_write() arms it.
+ */
+void fifo2_dma_init(void);
+
+/**
+ * @brief Send up to @p len bytes from @p src to FIFO#2 (WriterTask only).
+ *
+ * Stages the bytes as BSRR words, then blocks until they are all strobed
+ * or TXE# stops the chunk.
+ *
+ * @param src  Bytes to send, e.g. an rb_peek() region.
+ * @param len  Maximum bytes; clamped to FIFO2_DMA_CHUNK.
+ * @return Number of leading bytes the FT2232H accepted.  The rest were not
+ *         sent and must be offered again.
+ */
+uint32_t fifo2_dma_write(const uint8_t *src, uint32_t len);
+
+/**
+ * @brief TXE# edge callback, run from EXTI1_IRQHandler (fifo_exti.c) when
+ *        BRIDGE_WRITER_DMA is set.
+ */
+void fifo2_dma_txe_edge(void);
+
+#endif /* FIFO_DMA_H */
@@ -0,0 +1,80 @@
+/**
+ * @file fifo_exti.h
+ * @brief RXF# / TXE# edge interrupts (EXTI0 / EXTI1) for the FT2232HL
+ *        245-Sync-FIFO bridge on STM32H750.
+ *
+ * EXTI line n serves pin n of a single port.  Line 0 is routed to PC0
+ * (FIFO#1 RXF#) and line 1 to PD1 (FIFO#2 TXE#).  The pins that would
+ * compete for them, PD0 (FIFO#2 RXF#) and PC1 (FIFO#1 TXE#), are only used
+ * by the reverse channel, which polls them (fifo_reverse.c).  Both lines
+ * trigger on both edges and stay masked while nobody is waiting on them.
+ *
+ * Each line has one user per build:
+ *
+ *   BRIDGE_READER_DMA / BRIDGE_WRITER_DMA  the line gates that leg's strobe
+ *                                          timer (fifo_dma.c)
+ *   otherwise                              a task that finds its FIFO busy
+ *                                          sleeps in fifo_exti_wait()
+ *
+ * fifo_exti_wait() unmasks the line, re-checks the pin and blocks on
+ * BRIDGE_FLAG_FIFO.  The first edge masks the line again and sets the flag
+ * on the leg's task (g_reader_thread for RXF#, g_writer_thread for TXE#),
+ * so an idle bridge costs no CPU and resumes within the interrupt + context
+ * switch latency, a few microseconds.  Thread flags latch, so an edge
+ * between the re-check and the wait is not lost.
+ */
+
+#ifndef FIFO_EXTI_H
+#define FIFO_EXTI_H
+
+#include "fifo_bridge.h"
+
+/* ---- Configuration -------------------------------------------------- */
+
+/**
+ * Set to 0 to make idle tasks yield-spin on RXF# / TXE# instead of
+ * sleeping until the edge.
+ */
+#ifndef BRIDGE_EXTI_WAKE
+#define BRIDGE_EXTI_WAKE        1
+#endif
+
+/**
+ * NVIC priority of EXTI0 / EXTI1.  The handlers set thread flags, so it must
+ * not be above configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY (i.e.
+ * numerically ≥ 5).
+ */
+#ifndef FIFO_EXTI_IRQ_PRIORITY
+#define FIFO_EXTI_IRQ_PRIORITY  5u
+#endif
+
+/** EXTI line masks (line n = pin n) */
+#define FIFO_EXTI_RXF   ((uint32_t)FIFO1_RXF_PIN)  /**< EXTI0: PC0, FIFO#1 RXF# */
+#define FIFO_EXTI_TXE   ((uint32_t)FIFO2_TXE_PIN)  /**< EXTI1: PD1, FIFO#2 TXE# */
+
+/* ---- API ------------------------------------------------------------ */
+
+/**
+ * @brief Route PC0 → EXTI0 and PD1 → EXTI1 (both edges, masked) and enable
+ *        their NVIC lines.  Call once after MX_GPIO_Init().
+ */
+void fifo_exti_init(void);
+
+/** @brief Clear pending edges of @p lines and unmask them. */
+void fifo_exti_unmask(uint32_t lines);
+
+/** @brief Mask @p lines. */
+void fifo_exti_mask(uint32_t lines);
+
+/**
+ * @brief Sleep until FIFO#1 has data (FIFO_EXTI_RXF in @p lines) or FIFO#2
+ *        has room (FIFO_EXTI_TXE), whichever comes first.
+ *
+ * Returns at once if a condition already holds, and otherwise blocks until
+ * an edge (BridgeTask also when a telemetry frame is due).  Callers
+ * re-check the pins.  Only the task that owns a line may wait on it.  With
+ * BRIDGE_EXTI_WAKE=0 this is a plain osThreadYield().
+ */
+void fifo_exti_wait(uint32_t lines);
+
+#endif /* FIFO_EXTI_H */
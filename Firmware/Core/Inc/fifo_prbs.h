@@ -0,0 +1,92 @@
+/**
+ * @file fifo_prbs.h
+ * @brief PRBS-31 self-test mode (BRIDGE_PRBS_TEST=1): each leg runs on its
+ *        own against a PRBS-31 stream (prbs.h) instead of bridging.
+ *
+ *   Sender PC generator → FIFO#1 → PrbsCheckTask (checker)
+ *   PrbsGenTask (generator) → FIFO#2 → Receiver PC checker
+ *
+ * The two tasks take the places of ReaderTask and WriterTask and use the
+ * same leg engines (CPU strobes, or fifo1_dma_read() / fifo2_dma_write()
+ * with BRIDGE_READER_DMA / BRIDGE_WRITER_DMA), so each leg's maximum
+ * sustained rate and bit-error rate can be measured without the other leg
+ * or the ring buffer in the way.  Results are in g_fifo_prbs; the PC tools
+ * report their side of each leg.
+ *
+ * The checker locks onto the stream from any four bytes, so the Sender PC
+ * can start and stop at will.  A burst with more than one bit error in
+ * FIFO_PRBS_LOSS is taken as lost lock (dropped or repeated bytes, or a
+ * restarted generator): it is counted in resyncs, not in errors, and the
+ * checker relocks on its last four bytes.
+ */
+
+#ifndef FIFO_PRBS_H
+#define FIFO_PRBS_H
+
+#include "fifo_bridge.h"
+
+/* ---- Configuration -------------------------------------------------- */
+
+/** Set to 1 to replace the bridge with the PRBS generator and checker */
+#ifndef BRIDGE_PRBS_TEST
+#define BRIDGE_PRBS_TEST   0
+#endif
+
+/** Bit error ratio (1 in N) above which a burst counts as lost lock */
+#ifndef FIFO_PRBS_LOSS
+#define FIFO_PRBS_LOSS     4u
+#endif
+
+/** A leg idle for longer than this (ms) starts a new rate measurement */
+#ifndef FIFO_PRBS_GAP_MS
+#define FIFO_PRBS_GAP_MS   10u
+#endif
+
+#if BRIDGE_PRBS_TEST && \
+    (BRIDGE_USE_BLOCKS || BRIDGE_SINGLE_TASK || BRIDGE_REVERSE)
+#error "BRIDGE_PRBS_TEST replaces ReaderTask/WriterTask of the byte ring only"
+#endif
+
+/* ---- Results -------------------------------------------------------- */
+
+typedef struct {
+    uint32_t bytes;          /**< Bytes moved */
+    uint64_t stream_bytes;   /**< Bytes inside timed stretches */
+    uint64_t stream_cycles;  /**< DWT cycles of those stretches */
+    uint32_t last;           /**< CYCCNT after the previous burst */
+} fifo_prbs_rate_t;
+
+typedef struct {
+    fifo_prbs_rate_t rx;       /**< FIFO#1 → checker */
+    fifo_prbs_rate_t tx;       /**< Generator → FIFO#2 */
+    uint64_t         checked;  /**< Bytes compared while locked */
+    uint64_t         errors;   /**< Bit errors in those bytes */
+    uint32_t         resyncs;  /**< Bursts dropped for lost lock */
+    bool             locked;   /**< Checker follows the stream */
+} fifo_prbs_t;
+
+/*
+ * Sustained rate of a leg in bytes/s:
+ *   stream_bytes * SystemCoreClock / stream_cycles
+ * Gaps longer than FIFO_PRBS_GAP_MS (PC stopped) are left out of both.
+ */
+
+/* ---- API ------------------------------------------------------------ */
+
+#if BRIDGE_PRBS_TEST
+extern fifo_prbs_t g_fifo_prbs;
+
+/**
+ * @brief PrbsCheckTask – reads FIFO#1 and checks it against PRBS-31.
+ *        Runs in place of ReaderTask (g_reader_thread).
+ */
+void StartPrbsCheckTask(void *argument);
+
+/**
+ * @brief PrbsGenTask – writes an endless PRBS-31 stream to FIFO#2.
+ *        Runs in place of WriterTask (g_writer_thread).
+ */
+void StartPrbsGenTask(void *argument);
+#endif /* BRIDGE_PRBS_TEST */
+
+#endif /* FIFO_PRBS_H */
@@ -0,0 +1,484 @@
+/**
+ * @file fifo_strobe.h
+ * @brief CLKOUT-synchronous RD#/WR# strobe loops for the FT2232HL
+ *        245-Sync-FIFO bridge (CPU path of both legs).
+ *
+ * The FT2232H samples RD#, WR# and the write data, and updates RXF#, TXE#
+ * and the read data, on the rising edge of its 60 MHz CLKOUT.  A burst
+ * therefore first locks onto one rising CLKOUT edge (PC4 for FIFO#1, PD4
+ * for FIFO#2) and then schedules every bus access against the DWT cycle
+ * counter relative to the edges that follow, instead of padding with NOP
+ * loops whose length depends on the compiler and the pipeline.
+ *
+ * FT2232H datasheet, 245 synchronous FIFO timing (ns):
+ *
+ *   t4/t5/t11  CLKOUT → RXF#, read data, TXE# valid   ≤ 7.15
+ *   t9/t12/t14 RD#, write data, WR# setup to CLKOUT   ≥ 8
+ *   t10/t13/t15 hold after CLKOUT                     ≥ 0
+ *
+ * At 480 MHz one CPU cycle is 2.08 ns and one CLKOUT period 8 cycles.
+ * Relative to each strobed edge c (and c - T, the edge before it):
+ *
+ *   CLKOUT  _|‾‾‾‾|____|‾‾‾‾|____
+ *         c - T            c
+ *            |<-OPEN->| sample RXF#/TXE#/data
+ *            | drive RD#/WR#/data |<-SETUP->| release at c
+ *
+ *   OPEN  = 4 cycles (8.3 ns)  ≥ t4/t5/t11, margin 1.2 ns
+ *   SETUP = 4 cycles (8.3 ns)  ≥ t9/t12/t14, margin 0.3 ns
+ *   SKEW  = 2 cycles (4.2 ns)  edge lock uncertainty + GPIO write latency
+ *
+ * With BRIDGE_STROBE_CLKS = 1 RD#/WR# stay low for the whole burst and one
+ * byte moves per CLKOUT period: each loop iteration must finish its bus
+ * accesses within T - OPEN - SKEW = 2 cycles of slack.  With
+ * BRIDGE_STROBE_CLKS = N > 1 RD#/WR# are pulsed across every N-th edge
+ * only, which leaves (N - 1) * T cycles more per byte.
+ *
+ * A loop that finds itself past a deadline (an AHB4 stall, a slow build)
+ * ends the burst before touching the bus again and counts it in
+ * strobe_stats_t.late.  Pulsed mode loses nothing that way; in streaming
+ * mode RD#/WR# are already low, so the byte at that edge may have been
+ * lost (read) or repeated (write).  Run with late == 0 or raise
+ * BRIDGE_STROBE_CLKS.
+ *
+ * Interrupts are masked while a burst runs (≤ BRIDGE_BURST_LEN bytes,
+ * ≈1.1 µs at one byte per CLKOUT) so an ISR cannot stretch a strobe across
+ * extra edges.
+ *
+ * The figures above are the compile-time defaults.  Each leg reads its own
+ * strobe_timing_t, which fifo_calibrate() (fifo_calib.h) overwrites at boot
+ * with values derived from the CLKOUT actually measured on that leg.  The
+ * period is kept in 1/256 cycle so that SYSCLK settings that are not a
+ * multiple of 60 MHz stay in phase across a whole burst.
+ */
+
+#ifndef FIFO_STROBE_H
+#define FIFO_STROBE_H
+
+#include "fifo_bridge.h"
+#include "dwt.h"
+#include <string.h>
+
+/* ---- Default timing (CPU cycles at 480 MHz) ------------------------- */
+
+/** One CLKOUT period */
+#ifndef STROBE_CLKOUT_CYCLES
+#define STROBE_CLKOUT_CYCLES  8u
+#endif
+
+/** Edge → FT2232H outputs valid */
+#ifndef STROBE_OPEN
+#define STROBE_OPEN           4u
+#endif
+
+/** MCU outputs valid → edge */
+#ifndef STROBE_SETUP
+#define STROBE_SETUP          4u
+#endif
+
+/** Edge lock uncertainty plus GPIO write latency */
+#ifndef STROBE_SKEW
+#define STROBE_SKEW           2u
+#endif
+
+/**
+ * CLKOUT periods per byte: 1 streams (RD#/WR# held low), N > 1 pulses
+ * RD#/WR# across every N-th edge.
+ */
+#ifndef BRIDGE_STROBE_CLKS
+#define BRIDGE_STROBE_CLKS    1u
+#endif
+
+/** Give up locking onto CLKOUT after this many polls (clock not running) */
+#ifndef STROBE_SYNC_SPINS
+#define STROBE_SYNC_SPINS     64u
+#endif
+
+_Static_assert(BRIDGE_STROBE_CLKS >= 1u, "BRIDGE_STROBE_CLKS must be ≥ 1");
+_Static_assert(STROBE_OPEN + STROBE_SKEW < STROBE_CLKOUT_CYCLES &&
+               STROBE_SETUP + STROBE_SKEW <= STROBE_CLKOUT_CYCLES,
+               "strobe timing does not fit one CLKOUT period");
+
+/* ---- Per-leg timing and statistics ---------------------------------- */
+
+typedef struct {
+    uint32_t period_q8;  /**< CPU cycles per CLKOUT period, × 256 */
+    uint32_t open;       /**< Edge → FT2232H outputs valid (cycles) */
+    uint32_t setup;      /**< MCU outputs valid → edge (cycles) */
+    uint32_t skew;       /**< Edge lock uncertainty + write latency */
+    uint32_t clks;       /**< CLKOUT periods per byte (1 = streaming) */
+} strobe_timing_t;
+
+#define STROBE_TIMING_DEFAULT \
+    { STROBE_CLKOUT_CYCLES << 8, STROBE_OPEN, STROBE_SETUP, STROBE_SKEW, \
+      BRIDGE_STROBE_CLKS }
+
+/**
+ * @brief True if @p t can be scheduled at all: outputs must be valid, and
+ *        inputs set up, within one CLKOUT period of an edge.
+ */
+static inline bool strobe_timing_fits(const strobe_timing_t *t)
+{
+    uint32_t period = t->period_q8 >> 8;
+    return t->clks >= 1u &&
+           t->setup + t->skew <= period &&
+           (t->clks > 1u || t->open + t->skew < period);
+}
+
+typedef struct {
+    uint32_t bursts;  /**< Strobe bursts run */
+    uint32_t late;    /**< Bursts ended early by a missed deadline */
+} strobe_stats_t;
+
+extern strobe_timing_t g_fifo1_timing;      /**< FIFO#1 CLKOUT */
+extern strobe_timing_t g_fifo2_timing;      /**< FIFO#2 CLKOUT */
+extern strobe_stats_t  g_fifo1_strobe;      /**< FIFO#1 read bursts */
+extern strobe_stats_t  g_fifo2_strobe;      /**< FIFO#2 write bursts */
+#if BRIDGE_REVERSE
+extern strobe_stats_t  g_fifo2_rev_strobe;  /**< FIFO#2 read bursts */
+extern strobe_stats_t  g_fifo1_rev_strobe;  /**< FIFO#1 write bursts */
+#endif
+
+/* ---- Helpers -------------------------------------------------------- */
+
+/** Cycle time of offset @p q8 (1/256 cycles) after @p base, rounded down */
+#define STROBE_FLOOR(base, q8)  ((base) + ((q8) >> 8))
+
+/** Same, rounded up (for waits that must not end early) */
+#define STROBE_CEIL(base, q8)   ((base) + (((q8) + 255u) >> 8))
+
+/**
+ * @brief Wait for a rising CLKOUT edge and return its DWT timestamp.
+ *
+ * The edge is seen one GPIO read latency (plus at most one poll) after it
+ * happened, so the timestamp is late by up to the leg's skew: sampling
+ * later than scheduled is safe, and drive deadlines subtract the skew.
+ */
+static inline uint32_t strobe_sync(GPIO_TypeDef *port, uint32_t clk_pin)
+{
+    uint32_t spins = STROBE_SYNC_SPINS;
+    while ((port->IDR & clk_pin) != 0u && --spins != 0u) {
+    }
+    while ((port->IDR & clk_pin) == 0u && --spins != 0u) {
+    }
+    return dwt_cycles();
+}
+
+/* ---- Legs ----------------------------------------------------------- */
+
+/**
+ * Pins, timing and statistics of one transfer direction of one FT2232H.
+ * The loops below are generic over a leg and always inlined with one of
+ * the constant legs, so the fields fold into immediate operands.
+ */
+typedef struct {
+    GPIO_TypeDef    *ctrl;    /**< Flag, strobe, OE# and CLKOUT port */
+    GPIO_TypeDef    *data;    /**< D[7:0] port (pins 0..7) */
+    uint32_t         flag;    /**< RXF# (read leg) or TXE# (write leg) */
+    uint32_t         strobe;  /**< RD# (read leg) or WR# (write leg) */
+    uint32_t         oe;      /**< OE# */
+    uint32_t         clk;     /**< CLKOUT */
+    strobe_timing_t *timing;  /**< Timing of this FT2232H's CLKOUT */
+    strobe_stats_t  *stats;
+} strobe_leg_t;
+
+/** FIFO#1 → MCU (forward read) */
+static const strobe_leg_t k_fifo1_rx = {
+    FIFO1_CTRL_PORT, FIFO1_DATA_PORT, FIFO1_RXF_PIN, FIFO1_RD_PIN,
+    FIFO1_OE_PIN, FIFO1_CLKOUT_PIN, &g_fifo1_timing, &g_fifo1_strobe
+};
+
+/** MCU → FIFO#2 (forward write) */
+static const strobe_leg_t k_fifo2_tx = {
+    FIFO2_CTRL_PORT, FIFO2_DATA_PORT, FIFO2_TXE_PIN, FIFO2_WR_PIN,
+    FIFO2_OE_PIN, FIFO2_CLKOUT_PIN, &g_fifo2_timing, &g_fifo2_strobe
+};
+
+#if BRIDGE_REVERSE
+/** FIFO#2 → MCU (reverse read) */
+static const strobe_leg_t k_fifo2_rx = {
+    FIFO2_CTRL_PORT, FIFO2_DATA_PORT, FIFO2_RXF_PIN, FIFO2_RD_PIN,
+    FIFO2_OE_PIN, FIFO2_CLKOUT_PIN, &g_fifo2_timing, &g_fifo2_rev_strobe
+};
+
+/** MCU → FIFO#1 (reverse write) */
+static const strobe_leg_t k_fifo1_tx = {
+    FIFO1_CTRL_PORT, FIFO1_DATA_PORT, FIFO1_TXE_PIN, FIFO1_WR_PIN,
+    FIFO1_OE_PIN, FIFO1_CLKOUT_PIN, &g_fifo1_timing, &g_fifo1_rev_strobe
+};
+#endif
+
+/* ---- Bus direction -------------------------------------------------- */
+
+/** MODER field of D[7:0]: all inputs (0) / all general-purpose outputs */
+#define STROBE_DATA_MODER_MASK  0x0000FFFFu
+#define STROBE_DATA_MODER_OUT   0x00005555u
+
+/**
+ * @brief Let the FT2232H drive D[7:0] for a read: MCU pins to input, then
+ *        OE# low and one period of OE# setup.  No-op while OE# is low.
+ *
+ * Called with interrupts masked, at the start of every read burst, so a
+ * write burst on the same FT2232H can never find the bus half turned.
+ * OE# stays low across bursts; the tasks release it when the FIFO idles.
+ */
+__attribute__((always_inline))
+static inline void strobe_bus_read(const strobe_leg_t *leg)
+{
+    if ((leg->ctrl->ODR & leg->oe) != 0u) {
+        leg->data->MODER &= ~STROBE_DATA_MODER_MASK;
+        leg->ctrl->BSRR = leg->oe << 16;
+        dwt_wait_until(STROBE_CEIL(dwt_cycles(), leg->timing->period_q8) +
+                       leg->timing->skew);
+    }
+}
+
+/**
+ * @brief Take D[7:0] for a write: OE# high and one period for the FT2232H
+ *        to release the bus, then MCU pins to output.  No-op on a leg that
+ *        only ever writes (OE# high, pins already outputs).
+ */
+__attribute__((always_inline))
+static inline void strobe_bus_write(const strobe_leg_t *leg)
+{
+    if ((leg->ctrl->ODR & leg->oe) == 0u) {
+        leg->ctrl->BSRR = leg->oe;
+        dwt_wait_until(STROBE_CEIL(dwt_cycles(), leg->timing->period_q8) +
+                       leg->timing->skew);
+    }
+    uint32_t moder = leg->data->MODER;
+    if ((moder & STROBE_DATA_MODER_MASK) != STROBE_DATA_MODER_OUT) {
+        leg->data->MODER = (moder & ~STROBE_DATA_MODER_MASK) |
+                           STROBE_DATA_MODER_OUT;
+    }
+}
+
+/* ---- Read loop ------------------------------------------------------ */
+
+/** Bytes assembled in a register before one store to the destination */
+#define STROBE_READ_GROUP  8u
+
+/**
+ * @brief One read slot: sample the byte presented after edge *@p edge_q8
+ *        and consume it at the next strobed edge.
+ *
+ * @return false, with *@p edge_q8 unchanged, if RXF# was high (nothing
+ *         presented) or a deadline was missed.
+ */
+__attribute__((always_inline))
+static inline bool strobe_read_slot(const strobe_leg_t *leg,
+                                    const strobe_timing_t *t,
+                                    uint32_t slot_q8, uint32_t base,
+                                    uint32_t *edge_q8, uint8_t *b)
+{
+    uint32_t c_q8 = *edge_q8 + slot_q8;  /* edge that consumes the byte */
+    uint32_t c    = STROBE_FLOOR(base, c_q8);
+
+    dwt_wait_until(STROBE_CEIL(base, *edge_q8) + t->open);
+    *b = (uint8_t)(leg->data->IDR & 0xFFu);
+    if ((leg->ctrl->IDR & leg->flag) != 0u) {
+        return false;
+    }
+    if (t->clks == 1u) {
+        if (dwt_past(c - t->skew)) {
+            leg->stats->late++;
+            return false;
+        }
+    } else {
+        dwt_wait_until(STROBE_CEIL(base, c_q8 - t->period_q8));
+        if (dwt_past(c - t->setup - t->skew)) {
+            leg->stats->late++;  /* RD# could straddle edge c */
+            return false;
+        }
+        leg->ctrl->BSRR = leg->strobe << 16;
+        dwt_wait_until(STROBE_CEIL(base, c_q8));
+        leg->ctrl->BSRR = leg->strobe;
+    }
+    *edge_q8 = c_q8;
+    return true;
+}
+
+/**
+ * @brief Read up to @p len bytes from @p leg into @p dst, one per
+ *        timing.clks CLKOUT periods, until RXF# goes high.
+ *
+ * Each byte is sampled while it is on the bus (after the edge that
+ * presented it) and consumed by RD# being low at the next strobed edge.
+ * Bytes are gathered STROBE_READ_GROUP at a time in a 64-bit register,
+ * LSB first (stream order on the little-endian M7), by an unrolled loop
+ * that checks the length once per group; each full group is stored with
+ * one unaligned 64-bit copy.  A group cut short by RXF# has its bytes
+ * stored one by one; so has the final partial group of @p len.
+ *
+ * @return Bytes stored at @p dst.
+ */
+__attribute__((always_inline))
+static inline uint32_t strobe_read(const strobe_leg_t *leg, uint8_t *dst,
+                                   uint32_t len)
+{
+    const strobe_timing_t t = *leg->timing;
+    const uint32_t slot_q8  = t.clks * t.period_q8;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    strobe_bus_read(leg);
+
+    uint32_t n       = 0u;
+    uint32_t edge_q8 = 0u;
+    uint32_t base    = strobe_sync(leg->ctrl, leg->clk);
+    if (t.clks == 1u) {
+        leg->ctrl->BSRR = leg->strobe << 16;
+    }
+
+    bool more = true;
+    while (more && len - n >= STROBE_READ_GROUP) {
+        uint64_t word = 0u;
+        uint32_t k;
+#pragma GCC unroll 8
+        for (k = 0u; k < STROBE_READ_GROUP; k++) {
+            uint8_t b;
+            if (!strobe_read_slot(leg, &t, slot_q8, base, &edge_q8, &b)) {
+                more = false;
+                break;
+            }
+            word |= (uint64_t)b << (8u * k);
+        }
+        if (k == STROBE_READ_GROUP) {
+            memcpy(&dst[n], &word, sizeof(word));
+        } else {
+            for (uint32_t i = 0u; i < k; i++) {
+                dst[n + i] = (uint8_t)(word >> (8u * i));
+            }
+        }
+        n += k;
+    }
+
+    /* Tail shorter than a group */
+    while (more && n < len) {
+        uint8_t b;
+        more = strobe_read_slot(leg, &t, slot_q8, base, &edge_q8, &b);
+        if (more) {
+            dst[n++] = b;
+        }
+    }
+
+    if (t.clks == 1u) {
+        /* Release after the edge that consumed the last stored byte */
+        dwt_wait_until(STROBE_CEIL(base, edge_q8));
+        leg->ctrl->BSRR = leg->strobe;
+    }
+    leg->stats->bursts++;
+    __set_PRIMASK(primask);
+    return n;
+}
+
+/* ---- Write loop ----------------------------------------------------- */
+
+/**
+ * @brief Write up to @p len bytes from @p src to @p leg, one per
+ *        timing.clks CLKOUT periods, until TXE# goes high.
+ *
+ * Data and WR# are driven right after the edge before the strobed one;
+ * TXE# sampled in between tells whether the strobed edge accepts the byte.
+ * Bytes are loaded one 32-bit word at a time and peeled off LSB first,
+ * which is stream order on the little-endian M7.  Both data buses sit on
+ * pins 0..7, so FIFO2_BSRR() serves either.
+ *
+ * @return Bytes accepted (a prefix of @p src).
+ */
+__attribute__((always_inline))
+static inline uint32_t strobe_write(const strobe_leg_t *leg,
+                                    const uint8_t *src, uint32_t len)
+{
+    const strobe_timing_t t = *leg->timing;
+    const uint32_t slot_q8  = t.clks * t.period_q8;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    strobe_bus_write(leg);
+
+    uint32_t n       = 0u;
+    uint32_t word    = 0u;
+    uint32_t left    = 0u;
+    uint32_t edge_q8 = 0u;
+    uint32_t base    = strobe_sync(leg->ctrl, leg->clk);
+
+    while (n < len) {
+        uint32_t c_q8    = edge_q8 + slot_q8;  /* edge that accepts byte n */
+        uint32_t prev_q8 = c_q8 - t.period_q8;
+        uint32_t c       = STROBE_FLOOR(base, c_q8);
+
+        if (left == 0u) {
+            if (len - n >= sizeof(word)) {
+                memcpy(&word, &src[n], sizeof(word));
+                left = sizeof(word);
+            } else {
+                word = src[n];
+                left = 1u;
+            }
+        }
+
+        /* Look the BSRR word up while still waiting for the edge */
+        uint32_t bsrr = FIFO2_BSRR(word);
+
+        dwt_wait_until(STROBE_CEIL(base, prev_q8));
+        if (dwt_past(c - t.setup - t.skew)) {
+            leg->stats->late++;  /* data could change across edge c */
+            break;
+        }
+        leg->data->BSRR = bsrr;
+        leg->ctrl->BSRR = leg->strobe << 16;
+
+        dwt_wait_until(STROBE_CEIL(base, prev_q8) + t.open);
+        if ((leg->ctrl->IDR & leg->flag) != 0u) {
+            break;  /* FIFO full: edge c ignores the byte */
+        }
+        if (t.clks > 1u) {
+            dwt_wait_until(STROBE_CEIL(base, c_q8));
+            leg->ctrl->BSRR = leg->strobe;
+        }
+        word >>= 8;
+        left--;
+        n++;
+        edge_q8 = c_q8;
+    }
+
+    /* Release after the edge that took the last accepted byte */
+    dwt_wait_until(STROBE_CEIL(base, edge_q8));
+    leg->ctrl->BSRR = leg->strobe;
+    leg->stats->bursts++;
+    __set_PRIMASK(primask);
+    return n;
+}
+
+/* ---- Per-leg entry points ------------------------------------------- */
+
+/** @brief Forward read burst, FIFO#1 → @p dst (see strobe_read()) */
+BRIDGE_HOT_CODE static inline uint32_t fifo1_strobe_read(uint8_t *dst,
+                                                          uint32_t len)
+{
+    return strobe_read(&k_fifo1_rx, dst, len);
+}
+
+/** @brief Forward write burst, @p src → FIFO#2 (see strobe_write()) */
+BRIDGE_HOT_CODE static inline uint32_t fifo2_strobe_write(const uint8_t *src,
+                                                           uint32_t len)
+{
+    return strobe_write(&k_fifo2_tx, src, len);
+}
+
+#if BRIDGE_REVERSE
+/** @brief Reverse read burst, FIFO#2 → @p dst */
+static inline uint32_t fifo2_strobe_read(uint8_t *dst, uint32_t len)
+{
+    return strobe_read(&k_fifo2_rx, dst, len);
+}
+
+/** @brief Reverse write burst, @p src → FIFO#1 */
+static inline uint32_t fifo1_strobe_write(const uint8_t *src, uint32_t len)
+{
+    return strobe_write(&k_fifo1_tx, src, len);
+}
+#endif /* BRIDGE_REVERSE */
+
+#endif /* FIFO_STROBE_H */
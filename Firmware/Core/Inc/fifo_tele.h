@@ -0,0 +1,164 @@
+/**
+ * @file fifo_tele.h
+ * @brief In-band telemetry frames ("FIFT") in the FIFO#2 stream
+ *        (BRIDGE_TELEMETRY=1).
+ *
+ * Every FIFO_TELE_PERIOD_MS the write leg sends one fifo_tele_frame_t to
+ * the Receiver PC ahead of the next stream bytes.  A frame only goes out
+ * between FIFB transfers: a framing-only fifb.h tracker follows the bytes
+ * accepted by FIFO#2, so a frame never splits a header, payload or
+ * trailer.  During a long transfer the frame simply waits for its end.
+ *
+ * At 60 bytes per 100 ms a frame stream costs 600 B/s, well under 0.1 %
+ * of the link.  Collection is a few additions per burst plus one DWT read
+ * per idle-task switch (FreeRTOSConfig.h trace hooks) for the CPU load.
+ *
+ * BRIDGE_TELEMETRY must be set on the compiler command line (-D) so that
+ * FreeRTOSConfig.h sees it too.
+ */
+
+#ifndef FIFO_TELE_H
+#define FIFO_TELE_H
+
+#include "fifo_bridge.h"
+
+/* ---- Configuration -------------------------------------------------- */
+
+/** Set to 1 to send telemetry frames to the Receiver PC */
+#ifndef BRIDGE_TELEMETRY
+#define BRIDGE_TELEMETRY     0
+#endif
+
+/** Interval between frames */
+#ifndef FIFO_TELE_PERIOD_MS
+#define FIFO_TELE_PERIOD_MS  100u
+#endif
+
+#if BRIDGE_TELEMETRY && BRIDGE_USE_BLOCKS
+#error "BRIDGE_TELEMETRY requires the byte ring (BRIDGE_USE_BLOCKS=0)"
+#endif
+
+/* ---- Frame ---------------------------------------------------------- */
+
+#define FIFT_MAGIC    0x46494654u  /* "FIFT" as a little-endian uint32 */
+#define FIFT_VERSION  1u
+
+#define FIFT_FLAG_CRC    0x0001u   /**< crc_bad_* are counted (BRIDGE_CRC) */
+#define FIFT_FLAG_CALIB  0x0002u   /**< A CPU leg runs on fallback timing */
+
+/**
+ * Wire format, little-endian like the target, so the struct is sent as is.
+ * Counters are 32-bit and wrap; the receiver works with differences
+ * between frames.
+ */
+typedef struct {
+    uint32_t magic;        /**< FIFT_MAGIC */
+    uint16_t version;      /**< FIFT_VERSION */
+    uint16_t length;       /**< Bytes from seq up to (excluding) crc */
+    uint32_t seq;          /**< Frame number */
+    uint32_t uptime_ms;    /**< Since the scheduler started */
+    uint32_t bytes_in;     /**< Read from FIFO#1 */
+    uint32_t bytes_out;    /**< Stream bytes accepted by FIFO#2 */
+    uint32_t ring_full;    /**< Read leg found the ring buffer full */
+    uint32_t fifo2_full;   /**< Write leg found TXE# high */
+    uint32_t late;         /**< Strobe bursts cut short, both legs */
+    uint32_t buf_peak;     /**< Ring buffer peak since the last frame */
+    uint32_t buf_size;     /**< BRIDGE_BUF_SIZE */
+    uint32_t crc_bad_in;   /**< Bad transfers seen on FIFO#1 */
+    uint32_t crc_bad_out;  /**< Bad transfers seen on FIFO#2 */
+    uint16_t cpu_load;     /**< Non-idle time since the last frame, ‰ */
+    uint16_t flags;        /**< FIFT_FLAG_* */
+    uint32_t crc;          /**< CRC32 of all preceding frame bytes */
+} fifo_tele_frame_t;
+
+_Static_assert(sizeof(fifo_tele_frame_t) == 60u, "FIFT frame layout");
+
+/* ---- Counters ------------------------------------------------------- */
+
+typedef struct {
+    uint32_t bytes_in;
+    uint32_t bytes_out;
+    uint32_t ring_full;
+    uint32_t fifo2_full;
+    uint32_t peak;
+    uint32_t frames;       /**< Frames sent */
+} fifo_tele_t;
+
+/* ---- API ------------------------------------------------------------ */
+
+#if BRIDGE_TELEMETRY
+extern fifo_tele_t g_fifo_tele;
+
+/** @brief Reset the counters and the tracker.  Call before the scheduler */
+void fifo_tele_init(void);
+
+/**
+ * @brief Send (the rest of) a due telemetry frame to FIFO#2.  WriterTask
+ *        or BridgeTask only.
+ *
+ * @return true while a frame is still unsent; the caller must not send
+ *         stream bytes until it returns false.
+ */
+bool fifo_tele_send(void);
+
+/**
+ * @brief Longest the write leg may sleep while it has nothing else to send.
+ *
+ * @return Ticks until the next frame is due (0: due now), or osWaitForever
+ *         if the frame has to wait for more stream bytes anyway.
+ */
+uint32_t fifo_tele_idle_wait(void);
+
+/** @brief Account @p n stream bytes accepted by FIFO#2, starting at @p p */
+void fifo_tele_tx(const uint8_t *p, uint32_t n);
+
+/** @brief Idle task switched in / out (FreeRTOSConfig.h trace hooks) */
+void fifo_tele_idle_in(void);
+void fifo_tele_idle_out(void);
+
+/** @brief Account @p n bytes just committed to the ring buffer */
+static inline void fifo_tele_rx(uint32_t n)
+{
+    uint32_t fill = rb_count(&g_bridge_buf);
+
+    g_fifo_tele.bytes_in += n;
+    if (fill > g_fifo_tele.peak) {
+        g_fifo_tele.peak = fill;
+    }
+}
+
+static inline void fifo_tele_ring_full(void)
+{
+    g_fifo_tele.ring_full++;
+}
+
+static inline void fifo_tele_fifo2_full(void)
+{
+    g_fifo_tele.fifo2_full++;
+}
+#else
+static inline bool fifo_tele_send(void)
+{
+    return false;
+}
+
+static inline uint32_t fifo_tele_idle_wait(void)
+{
+    return osWaitForever;
+}
+
+static inline void fifo_tele_tx(const uint8_t *p, uint32_t n)
+{
+    (void)p; (void)n;
+}
+
+static inline void fifo_tele_rx(uint32_t n)
+{
+    (void)n;
+}
+
+static inline void fifo_tele_ring_full(void) {}
+static inline void fifo_tele_fifo2_full(void) {}
+#endif /* BRIDGE_TELEMETRY */
+
+#endif /* FIFO_TELE_H */
@@ -0,0 +1,118 @@
+/**
+ * @file prbs.h
+ * @brief PRBS-31 (x^31 + x^28 + 1) byte generator and checker.
+ *
+ * Stream format: the PRBS-31 bit sequence (Fibonacci LFSR, not inverted),
+ * packed eight bits per byte with the earliest bit in the MSB.  The 31-bit
+ * state is the last 31 bits sent, so a checker synchronises itself from any
+ * four consecutive received bytes; no seed has to be agreed on.
+ *
+ * Header-only with no MCU dependencies, so the same code runs on the target
+ * and in host tests.
+ */
+
+#ifndef PRBS_H
+#define PRBS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define PRBS31_MASK  0x7FFFFFFFu
+
+typedef struct {
+    uint32_t state;  /**< Last 31 bits of the sequence, newest in bit 0 */
+} prbs31_t;
+
+/**
+ * @brief Start a generator from @p seed (any non-zero 31-bit value).
+ */
+static inline void prbs31_init(prbs31_t *p, uint32_t seed)
+{
+    seed &= PRBS31_MASK;
+    p->state = (seed != 0u) ? seed : 1u;
+}
+
+/**
+ * @brief Next eight bits of the sequence.
+ *
+ * Bit n is bit n-31 XOR bit n-28; for the next eight bits all taps are
+ * already in the state, so the whole byte is computed in one step.
+ */
+static inline uint8_t prbs31_next(prbs31_t *p)
+{
+    uint32_t s   = p->state;
+    uint8_t  out = (uint8_t)((s >> 23) ^ (s >> 20));
+    p->state = ((s << 8) | out) & PRBS31_MASK;
+    return out;
+}
+
+/**
+ * @brief Next 24 bits of the sequence, earliest bit in bit 23.
+ *
+ * Every bit up to 28 ahead still has both taps in the state, so three
+ * bytes come out of one step.
+ */
+static inline uint32_t prbs31_next24(prbs31_t *p)
+{
+    uint32_t s   = p->state;
+    uint32_t out = ((s >> 7) ^ (s >> 4)) & 0xFFFFFFu;
+    p->state = ((s << 24) | out) & PRBS31_MASK;
+    return out;
+}
+
+/**
+ * @brief Fill @p dst with the next @p len bytes of the sequence.
+ */
+static inline void prbs31_fill(prbs31_t *p, uint8_t *dst, uint32_t len)
+{
+    uint32_t i = 0u;
+    for (; i + 3u <= len; i += 3u) {
+        uint32_t w = prbs31_next24(p);
+        dst[i]      = (uint8_t)(w >> 16);
+        dst[i + 1u] = (uint8_t)(w >> 8);
+        dst[i + 2u] = (uint8_t)w;
+    }
+    for (; i < len; i++) {
+        dst[i] = prbs31_next(p);
+    }
+}
+
+/**
+ * @brief Lock a checker onto a received stream from four consecutive bytes.
+ *
+ * @return false if the bytes are all zero (not a PRBS-31 stream).
+ */
+static inline bool prbs31_sync(prbs31_t *p, const uint8_t b[4])
+{
+    uint32_t s = ((uint32_t)b[0] << 24) | ((uint32_t)b[1] << 16) |
+                 ((uint32_t)b[2] << 8)  |  (uint32_t)b[3];
+    p->state = s & PRBS31_MASK;
+    return p->state != 0u;
+}
+
+/**
+ * @brief Compare @p len received bytes against the sequence.
+ *
+ * The checker keeps following the expected sequence, so a dropped or
+ * repeated byte shows up as a burst of errors rather than being absorbed.
+ *
+ * @return Number of bit errors.
+ */
+static inline uint32_t prbs31_check(prbs31_t *p, const uint8_t *src,
+                                    uint32_t len)
+{
+    uint32_t errors = 0u;
+    uint32_t i      = 0u;
+    for (; i + 3u <= len; i += 3u) {
+        uint32_t got = ((uint32_t)src[i] << 16) | ((uint32_t)src[i + 1u] << 8) |
+                       (uint32_t)src[i + 2u];
+        errors += (uint32_t)__builtin_popcount(got ^ prbs31_next24(p));
+    }
+    for (; i < len; i++) {
+        errors += (uint32_t)__builtin_popcount((uint8_t)(src[i] ^
+                                                         prbs31_next(p)));
+    }
+    return errors;
+}
+
+#endif /* PRBS_H */
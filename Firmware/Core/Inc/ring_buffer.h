@@ -3,8 +3,12 @@
  * @brief Lock-free single-producer / single-consumer ring buffer for the
  *        FT2232HL FIFO bridge running on STM32H750.
  *
- * The buffer lives in AXI-SRAM (D1 domain), which is cache-coherent through
- * the Cortex-M7 D-cache.  Because only ONE task writes and ONE task reads, no
+ * The ring buffer descriptor does not own its storage: the caller hands a
+ * power-of-two sized byte array to rb_init(), so each instance can have its
+ * own size and placement (e.g. a large elastic buffer in AXI-SRAM).
+ *
+ * The bridge buffer lives in AXI-SRAM (D1 domain), which is cache-coherent
+ * through the Cortex-M7 D-cache.  Because only ONE task writes and ONE task reads, no
  * critical section is required – the head/tail indices are declared volatile so
  * the compiler always re-reads them from memory.
  *
@@ -15,7 +19,10 @@
  *   buffer you MUST either:
  *     a) Place the buffer in a non-cacheable MPU region, OR
  *     b) Call SCB_InvalidateDCache_by_Addr() before reading transferred data.
- *   This driver does NOT use DMA, so no extra cache maintenance is needed.
+ *   The ring itself never touches the cache.  With BRIDGE_READER_DMA=1,
+ *   DMA1 fills rb_reserve() regions of the bridge buffer, and
+ *   fifo1_dma_read() (fifo_dma.c) invalidates each chunk before it is
+ *   committed and cleans the bytes it moves while compacting.
  */
 
 #ifndef RING_BUFFER_H
@@ -24,23 +31,93 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
+#include <string.h>
+
+/* ---- Optional instrumentation ---------------------------------------- */
+
+/**
+ * Set RB_ENABLE_STATS to 1 (e.g. -DRB_ENABLE_STATS=1) to record occupancy
+ * and pressure statistics in every ring buffer.  When 0 (the default) the
+ * hooks compile to nothing and ring_buffer_t carries no extra fields.
+ *
+ * Every field has exactly one writer, so the SPSC contract still holds:
+ *   peak, samples, hist[] – producer, sampled on every publish (per burst)
+ *   full_events           – producer, each push/reserve that found no space
+ *   empty_events          – consumer, each pop/peek that found no data
+ */
+#ifndef RB_ENABLE_STATS
+#define RB_ENABLE_STATS  0
+#endif
+
+#define RB_STATS_HIST_BINS  8u  /**< Occupancy histogram in 1/8ths of capacity */
 
-#define RING_BUFFER_SIZE  4096u   /**< Must be a power of two */
-#define RING_BUFFER_MASK  (RING_BUFFER_SIZE - 1u)
+typedef struct {
+    uint32_t peak;                      /**< Highest occupancy seen (bytes) */
+    uint32_t full_events;               /**< Push/reserve on a full buffer */
+    uint32_t empty_events;              /**< Pop/peek on an empty buffer */
+    uint32_t samples;                   /**< Number of histogram samples */
+    uint32_t hist[RB_STATS_HIST_BINS];  /**< Samples per occupancy bin */
+} rb_stats_t;
 
 typedef struct {
-    uint8_t  buf[RING_BUFFER_SIZE];
+    uint8_t  *buf;           /**< Caller-provided storage */
+    uint32_t  size;          /**< Storage size in bytes (power of two) */
+    uint32_t  mask;          /**< size - 1 */
     volatile uint32_t head;  /**< Written by producer */
     volatile uint32_t tail;  /**< Written by consumer */
+#if RB_ENABLE_STATS
+    rb_stats_t stats;
+    uint32_t   hist_shift;   /**< occupancy >> hist_shift = histogram bin */
+#endif
 } ring_buffer_t;
 
+#if RB_ENABLE_STATS
+/** Producer: record the occupancy after a publish */
+static inline void rb_stats_sample_(ring_buffer_t *rb)
+{
+    uint32_t occ = (rb->head - rb->tail) & rb->mask;
+    if (occ > rb->stats.peak) {
+        rb->stats.peak = occ;
+    }
+    rb->stats.hist[occ >> rb->hist_shift]++;
+    rb->stats.samples++;
+}
+#define RB_STATS_SAMPLE(rb)  rb_stats_sample_(rb)
+#define RB_STATS_FULL(rb)    ((rb)->stats.full_events++)
+#define RB_STATS_EMPTY(rb)   ((rb)->stats.empty_events++)
+#else
+#define RB_STATS_SAMPLE(rb)  ((void)0)
+#define RB_STATS_FULL(rb)    ((void)0)
+#define RB_STATS_EMPTY(rb)   ((void)0)
+#endif
+
 /**
- * @brief Initialise a ring buffer (zero head and tail).
+ * @brief Initialise a ring buffer over caller-provided storage.
+ *
+ * @param storage  Backing array; must outlive the ring buffer.
+ * @param size     Size of @p storage in bytes.  Must be a power of two
+ *                 (≥ 2); one slot is kept free to tell full from empty.
+ * @return false if @p storage is NULL or @p size is not a power of two.
  */
-static inline void rb_init(ring_buffer_t *rb)
+static inline bool rb_init(ring_buffer_t *rb, uint8_t *storage, uint32_t size)
 {
+    if (storage == NULL || size < 2u || (size & (size - 1u)) != 0u) {
+        return false;
+    }
+    rb->buf  = storage;
+    rb->size = size;
+    rb->mask = size - 1u;
     rb->head = 0u;
     rb->tail = 0u;
+#if RB_ENABLE_STATS
+    memset(&rb->stats, 0, sizeof(rb->stats));
+    rb->hist_shift = (uint32_t)__builtin_ctz(size) -
+                     (uint32_t)__builtin_ctz(RB_STATS_HIST_BINS);
+    if (size < RB_STATS_HIST_BINS) {
+        rb->hist_shift = 0u;
+    }
+#endif
+    return true;
 }
 
 /**
@@ -48,7 +125,7 @@ static inline void rb_init(ring_buffer_t *rb)
  */
 static inline uint32_t rb_count(const ring_buffer_t *rb)
 {
-    return (rb->head - rb->tail) & RING_BUFFER_MASK;
+    return (rb->head - rb->tail) & rb->mask;
 }
 
 /**
@@ -56,7 +133,7 @@ static inline uint32_t rb_count(const ring_buffer_t *rb)
  */
 static inline uint32_t rb_free(const ring_buffer_t *rb)
 {
-    return RING_BUFFER_MASK - rb_count(rb);
+    return rb->mask - rb_count(rb);
 }
 
 /**
@@ -81,12 +158,14 @@ static inline bool rb_full(const ring_buffer_t *rb)
 static inline bool rb_push(ring_buffer_t *rb, uint8_t byte)
 {
     if (rb_full(rb)) {
+        RB_STATS_FULL(rb);
         return false;
     }
-    rb->buf[rb->head & RING_BUFFER_MASK] = byte;
+    rb->buf[rb->head & rb->mask] = byte;
     /* Compiler barrier so the store to buf[] is visible before head update */
     __asm volatile ("" ::: "memory");
     rb->head++;
+    RB_STATS_SAMPLE(rb);
     return true;
 }
 
@@ -96,12 +175,298 @@ static inline bool rb_push(ring_buffer_t *rb, uint8_t byte)
 static inline bool rb_pop(ring_buffer_t *rb, uint8_t *byte)
 {
     if (rb_empty(rb)) {
+        RB_STATS_EMPTY(rb);
         return false;
     }
-    *byte = rb->buf[rb->tail & RING_BUFFER_MASK];
+    *byte = rb->buf[rb->tail & rb->mask];
     __asm volatile ("" ::: "memory");
     rb->tail++;
     return true;
 }
 
+/**
+ * @brief Push up to @p n bytes from @p src.
+ *
+ * Copies as many bytes as fit (at most two memcpy() calls when the span
+ * wraps) and publishes them with a single head update.
+ *
+ * @return Number of bytes actually written (0 when the buffer is full).
+ */
+static inline uint32_t rb_write(ring_buffer_t *rb, const uint8_t *src, uint32_t n)
+{
+    uint32_t space = rb_free(rb);
+    if (space == 0u) {
+        RB_STATS_FULL(rb);
+        return 0u;
+    }
+    if (n > space) {
+        n = space;
+    }
+    if (n == 0u) {
+        return 0u;
+    }
+
+    uint32_t idx   = rb->head & rb->mask;
+    uint32_t first = rb->size - idx;
+    if (first > n) {
+        first = n;
+    }
+    memcpy(&rb->buf[idx], src, first);
+    memcpy(&rb->buf[0], src + first, n - first);
+
+    /* Publish the whole span at once */
+    __asm volatile ("" ::: "memory");
+    rb->head += n;
+    RB_STATS_SAMPLE(rb);
+    return n;
+}
+
+/**
+ * @brief Pop up to @p n bytes into @p dst.
+ *
+ * Mirror of rb_write(): at most two memcpy() calls and one tail update.
+ *
+ * @return Number of bytes actually read (0 when the buffer is empty).
+ */
+static inline uint32_t rb_read(ring_buffer_t *rb, uint8_t *dst, uint32_t n)
+{
+    uint32_t avail = rb_count(rb);
+    if (avail == 0u) {
+        RB_STATS_EMPTY(rb);
+        return 0u;
+    }
+    if (n > avail) {
+        n = avail;
+    }
+    if (n == 0u) {
+        return 0u;
+    }
+    /* Do not let the buf[] loads be hoisted above the head read */
+    __asm volatile ("" ::: "memory");
+
+    uint32_t idx   = rb->tail & rb->mask;
+    uint32_t first = rb->size - idx;
+    if (first > n) {
+        first = n;
+    }
+    memcpy(dst, &rb->buf[idx], first);
+    memcpy(dst + first, &rb->buf[0], n - first);
+
+    __asm volatile ("" ::: "memory");
+    rb->tail += n;
+    return n;
+}
+
+/* ---- Word access ----------------------------------------------------- */
+
+/*
+ * Move 4 or 8 bytes with one index publish.  A word holds consecutive
+ * stream bytes in little-endian order: the first byte is the least
+ * significant one, matching the Cortex-M7 byte order, so a word store lays
+ * the bytes out exactly as rb_push() would.
+ *
+ * When the word does not cross the physical end of the buffer it is moved
+ * with a single (possibly unaligned, which the M7 handles for LDR/STR)
+ * load/store; a word that straddles the wrap falls back to byte copies.
+ * Keep the producer and consumer in whole words and a power-of-two buffer
+ * never straddles, since the indices then stay word-aligned.
+ */
+
+/** Copy @p len bytes of @p word into the buffer starting at index @p idx */
+static inline void rb_store_word_(ring_buffer_t *rb, uint32_t idx,
+                                  const void *word, uint32_t len)
+{
+    if (idx + len <= rb->size) {
+        memcpy(&rb->buf[idx], word, len);
+    } else {
+        const uint8_t *b = (const uint8_t *)word;
+        for (uint32_t i = 0u; i < len; i++) {
+            rb->buf[(idx + i) & rb->mask] = b[i];
+        }
+    }
+}
+
+/** Copy @p len bytes starting at index @p idx out of the buffer */
+static inline void rb_load_word_(const ring_buffer_t *rb, uint32_t idx,
+                                 void *word, uint32_t len)
+{
+    if (idx + len <= rb->size) {
+        memcpy(word, &rb->buf[idx], len);
+    } else {
+        uint8_t *b = (uint8_t *)word;
+        for (uint32_t i = 0u; i < len; i++) {
+            b[i] = rb->buf[(idx + i) & rb->mask];
+        }
+    }
+}
+
+/**
+ * @brief Push 4 bytes (first stream byte in bits 7:0).
+ *
+ * @return false, writing nothing, if fewer than 4 bytes are free.
+ */
+static inline bool rb_push_u32(ring_buffer_t *rb, uint32_t word)
+{
+    if (rb_free(rb) < sizeof(word)) {
+        RB_STATS_FULL(rb);
+        return false;
+    }
+    rb_store_word_(rb, rb->head & rb->mask, &word, sizeof(word));
+    __asm volatile ("" ::: "memory");
+    rb->head += sizeof(word);
+    RB_STATS_SAMPLE(rb);
+    return true;
+}
+
+/**
+ * @brief Push 8 bytes (first stream byte in bits 7:0).
+ *
+ * @return false, writing nothing, if fewer than 8 bytes are free.
+ */
+static inline bool rb_push_u64(ring_buffer_t *rb, uint64_t word)
+{
+    if (rb_free(rb) < sizeof(word)) {
+        RB_STATS_FULL(rb);
+        return false;
+    }
+    rb_store_word_(rb, rb->head & rb->mask, &word, sizeof(word));
+    __asm volatile ("" ::: "memory");
+    rb->head += sizeof(word);
+    RB_STATS_SAMPLE(rb);
+    return true;
+}
+
+/**
+ * @brief Pop 4 bytes (first stream byte in bits 7:0).
+ *
+ * @return false, reading nothing, if fewer than 4 bytes are stored; drain
+ *         a shorter tail with rb_pop() / rb_read().
+ */
+static inline bool rb_pop_u32(ring_buffer_t *rb, uint32_t *word)
+{
+    if (rb_count(rb) < sizeof(*word)) {
+        RB_STATS_EMPTY(rb);
+        return false;
+    }
+    __asm volatile ("" ::: "memory");
+    rb_load_word_(rb, rb->tail & rb->mask, word, sizeof(*word));
+    __asm volatile ("" ::: "memory");
+    rb->tail += sizeof(*word);
+    return true;
+}
+
+/**
+ * @brief Pop 8 bytes (first stream byte in bits 7:0).
+ *
+ * @return false, reading nothing, if fewer than 8 bytes are stored.
+ */
+static inline bool rb_pop_u64(ring_buffer_t *rb, uint64_t *word)
+{
+    if (rb_count(rb) < sizeof(*word)) {
+        RB_STATS_EMPTY(rb);
+        return false;
+    }
+    __asm volatile ("" ::: "memory");
+    rb_load_word_(rb, rb->tail & rb->mask, word, sizeof(*word));
+    __asm volatile ("" ::: "memory");
+    rb->tail += sizeof(*word);
+    return true;
+}
+
+/* ---- Zero-copy access ------------------------------------------------ */
+
+/**
+ * @brief Producer: expose the contiguous free region starting at head.
+ *
+ * The region ends at the physical end of the buffer or at the last free
+ * slot, whichever comes first.  The producer fills it directly and then
+ * publishes the bytes with rb_commit().  Nothing is visible to the consumer
+ * until then.
+ *
+ * @param[out] ptr  Start of the writable region.
+ * @return Length of the region in bytes (0 when the buffer is full).
+ */
+static inline uint32_t rb_reserve(ring_buffer_t *rb, uint8_t **ptr)
+{
+    uint32_t idx   = rb->head & rb->mask;
+    uint32_t space = rb_free(rb);
+    uint32_t first = rb->size - idx;
+
+    if (space == 0u) {
+        RB_STATS_FULL(rb);
+    }
+    *ptr = &rb->buf[idx];
+    return (space < first) ? space : first;
+}
+
+/**
+ * @brief Producer: publish @p n bytes previously written via rb_reserve().
+ *
+ * @p n must not exceed the length returned by the matching rb_reserve().
+ */
+static inline void rb_commit(ring_buffer_t *rb, uint32_t n)
+{
+    __asm volatile ("" ::: "memory");
+    rb->head += n;
+    RB_STATS_SAMPLE(rb);
+}
+
+/**
+ * @brief Consumer: expose the contiguous readable region starting at tail.
+ *
+ * @param[out] ptr  Start of the readable region.
+ * @return Length of the region in bytes (0 when the buffer is empty).
+ */
+static inline uint32_t rb_peek(ring_buffer_t *rb, const uint8_t **ptr)
+{
+    uint32_t idx   = rb->tail & rb->mask;
+    uint32_t avail = rb_count(rb);
+    uint32_t first = rb->size - idx;
+
+    if (avail == 0u) {
+        RB_STATS_EMPTY(rb);
+    }
+    __asm volatile ("" ::: "memory");
+    *ptr = &rb->buf[idx];
+    return (avail < first) ? avail : first;
+}
+
+/**
+ * @brief Consumer: hand @p n bytes obtained via rb_peek() back to the
+ *        producer.
+ *
+ * @p n must not exceed the length returned by the matching rb_peek().
+ */
+static inline void rb_release(ring_buffer_t *rb, uint32_t n)
+{
+    __asm volatile ("" ::: "memory");
+    rb->tail += n;
+}
+
+/* ---- Statistics access ---------------------------------------------- */
+
+#if RB_ENABLE_STATS
+/**
+ * @brief Copy the statistics of @p rb into @p out.
+ *
+ * Safe from any context; fields are read individually, so a snapshot taken
+ * while the tasks run may mix values from adjacent bursts.
+ */
+static inline void rb_stats_get(const ring_buffer_t *rb, rb_stats_t *out)
+{
+    *out = rb->stats;
+}
+
+/**
+ * @brief Clear the statistics of @p rb.
+ *
+ * Only call while neither side is running (e.g. before the scheduler
+ * starts), since it writes fields owned by both sides.
+ */
+static inline void rb_stats_reset(ring_buffer_t *rb)
+{
+    memset(&rb->stats, 0, sizeof(rb->stats));
+}
+#endif /* RB_ENABLE_STATS */
+
 #endif /* RING_BUFFER_H */
@@ -0,0 +1,305 @@
+/**
+ * @file ring_buffer_dma.h
+ * @brief DMA/ISR-safe single-producer / single-consumer ring buffer variant
+ *        for the FT2232HL FIFO bridge running on STM32H750.
+ *
+ * ring_buffer.h is enough for two tasks on one core: a compiler barrier
+ * orders the stores, and the CPU is the only bus master that touches the
+ * data.  Once one side is a DMA/MDMA stream or an ISR, three things change:
+ *
+ *   1. Ordering.  Index publication uses a DMB so that data written before
+ *      rbd_commit()/rbd_release() is observable by the other side before the
+ *      index update (release), and index reads are followed by a DMB so data
+ *      loads are not performed before the index load (acquire).
+ *
+ *   2. Cache coherency.  With the D-cache on, data written by DMA is not seen
+ *      by the CPU until the stale lines are invalidated, and data written by
+ *      the CPU is not seen by DMA until the dirty lines are cleaned.  Which
+ *      maintenance is needed is declared per side at init time
+ *      (RBD_PRODUCER_DMA / RBD_CONSUMER_DMA).
+ *
+ *   3. Index isolation.  head and tail each sit alone on their own 32-byte
+ *      cache line, separate from each other and from the data.  Cache
+ *      maintenance on the data region (which rounds to whole lines) therefore
+ *      never discards a pending index update, and producer/consumer index
+ *      writes never share a line.
+ *
+ * Indices are free-running 32-bit counters: count = head - tail, and the
+ * buffer is full when count == size, so all @c size bytes are usable
+ * (ring_buffer.h keeps one slot free instead).
+ *
+ * Storage requirements: 32-byte aligned, size a power of two and at least
+ * one cache line.  The storage must be used for nothing else, since cache
+ * maintenance is rounded out to whole lines inside it.
+ */
+
+#ifndef RING_BUFFER_DMA_H
+#define RING_BUFFER_DMA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(__arm__)
+#include "stm32h7xx.h"
+#endif
+
+/** Cortex-M7 D-cache line size in bytes */
+#define RBD_CACHE_LINE  32u
+
+/* ---- Barrier / cache maintenance hooks --------------------------------- */
+
+#if defined(__arm__)
+#define RBD_DMB()  __DMB()
+#else
+#define RBD_DMB()  __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+#define RBD_CACHE_CLEAN(addr, len) \
+    SCB_CleanDCache_by_Addr((void *)(addr), (int32_t)(len))
+#define RBD_CACHE_INVALIDATE(addr, len) \
+    SCB_InvalidateDCache_by_Addr((void *)(addr), (int32_t)(len))
+#else
+#define RBD_CACHE_CLEAN(addr, len)      ((void)(addr), (void)(len))
+#define RBD_CACHE_INVALIDATE(addr, len) ((void)(addr), (void)(len))
+#endif
+
+/* ---- Side flags -------------------------------------------------------- */
+
+#define RBD_PRODUCER_DMA  0x01u  /**< Data is written by a DMA/MDMA stream */
+#define RBD_CONSUMER_DMA  0x02u  /**< Data is read by a DMA/MDMA stream */
+
+typedef struct {
+    /** Written by producer only – alone on its cache line */
+    volatile uint32_t head __attribute__((aligned(RBD_CACHE_LINE)));
+    uint8_t  pad_head[RBD_CACHE_LINE - sizeof(uint32_t)];
+
+    /** Written by consumer only – alone on its cache line */
+    volatile uint32_t tail __attribute__((aligned(RBD_CACHE_LINE)));
+    uint8_t  pad_tail[RBD_CACHE_LINE - sizeof(uint32_t)];
+
+    /* Read-only after rbd_init() */
+    uint8_t  *buf __attribute__((aligned(RBD_CACHE_LINE)));
+    uint32_t  size;
+    uint32_t  mask;
+    uint32_t  flags;
+} rbd_t;
+
+/* ---- Private helpers --------------------------------------------------- */
+
+/** Cache-maintain [buf+idx, buf+idx+len) rounded out to whole lines */
+static inline void rbd_cache_op_(const rbd_t *rb, uint32_t idx, uint32_t len,
+                                 bool clean)
+{
+    uint32_t start = idx & ~(RBD_CACHE_LINE - 1u);
+    uint32_t end   = (idx + len + RBD_CACHE_LINE - 1u) & ~(RBD_CACHE_LINE - 1u);
+
+    if (clean) {
+        RBD_CACHE_CLEAN(&rb->buf[start], end - start);
+    } else {
+        RBD_CACHE_INVALIDATE(&rb->buf[start], end - start);
+    }
+}
+
+/** Acquire-load of the other side's index */
+static inline uint32_t rbd_load_acquire_(const volatile uint32_t *idx)
+{
+    uint32_t v = *idx;
+    RBD_DMB();
+    return v;
+}
+
+/* ---- Public API -------------------------------------------------------- */
+
+/**
+ * @brief Initialise a DMA-safe ring buffer over caller-provided storage.
+ *
+ * @param storage  32-byte aligned backing array; must outlive the buffer.
+ * @param size     Size of @p storage in bytes; power of two, ≥ 32.
+ * @param flags    RBD_PRODUCER_DMA and/or RBD_CONSUMER_DMA, or 0.
+ * @return false if the storage does not meet the requirements above.
+ */
+static inline bool rbd_init(rbd_t *rb, uint8_t *storage, uint32_t size,
+                            uint32_t flags)
+{
+    if (storage == NULL ||
+        ((uintptr_t)storage & (RBD_CACHE_LINE - 1u)) != 0u ||
+        size < RBD_CACHE_LINE || (size & (size - 1u)) != 0u) {
+        return false;
+    }
+    rb->buf   = storage;
+    rb->size  = size;
+    rb->mask  = size - 1u;
+    rb->flags = flags;
+    rb->head  = 0u;
+    rb->tail  = 0u;
+    RBD_DMB();
+    return true;
+}
+
+/**
+ * @brief Bytes currently stored (may be called from either side).
+ */
+static inline uint32_t rbd_count(const rbd_t *rb)
+{
+    uint32_t tail = rb->tail;
+    uint32_t head = rb->head;
+    RBD_DMB();
+    return head - tail;
+}
+
+/**
+ * @brief Free bytes (may be called from either side).
+ */
+static inline uint32_t rbd_free(const rbd_t *rb)
+{
+    return rb->size - rbd_count(rb);
+}
+
+/**
+ * @brief Producer: expose the contiguous free region starting at head.
+ *
+ * When the consumer is a DMA stream, nothing needs to be done here; the
+ * region is cleaned in rbd_commit().  When the producer is a DMA stream the
+ * region must not be written by the CPU, and its lines are invalidated by
+ * the consumer in rbd_peek().
+ *
+ * @param[out] ptr  Start of the writable region.
+ * @return Length of the region in bytes (0 when full).
+ */
+static inline uint32_t rbd_reserve(rbd_t *rb, uint8_t **ptr)
+{
+    uint32_t head  = rb->head;
+    uint32_t tail  = rbd_load_acquire_(&rb->tail);
+    uint32_t idx   = head & rb->mask;
+    uint32_t space = rb->size - (head - tail);
+    uint32_t first = rb->size - idx;
+
+    *ptr = &rb->buf[idx];
+    return (space < first) ? space : first;
+}
+
+/**
+ * @brief Producer: publish @p n bytes written into the reserved region.
+ *
+ * Release semantics: cleans the region first if the consumer is a DMA
+ * stream, then a DMB orders the data before the head update.
+ */
+static inline void rbd_commit(rbd_t *rb, uint32_t n)
+{
+    uint32_t head = rb->head;
+
+    if ((rb->flags & RBD_CONSUMER_DMA) != 0u && n != 0u) {
+        uint32_t idx   = head & rb->mask;
+        uint32_t first = rb->size - idx;
+        if (first >= n) {
+            rbd_cache_op_(rb, idx, n, true);
+        } else {
+            rbd_cache_op_(rb, idx, first, true);
+            rbd_cache_op_(rb, 0u, n - first, true);
+        }
+    }
+    RBD_DMB();
+    rb->head = head + n;
+}
+
+/**
+ * @brief Consumer: expose the contiguous readable region starting at tail.
+ *
+ * Acquire semantics: the head load is followed by a DMB, and the region is
+ * invalidated if the producer is a DMA stream so the CPU does not read stale
+ * lines.
+ *
+ * @param[out] ptr  Start of the readable region.
+ * @return Length of the region in bytes (0 when empty).
+ */
+static inline uint32_t rbd_peek(rbd_t *rb, const uint8_t **ptr)
+{
+    uint32_t tail  = rb->tail;
+    uint32_t head  = rbd_load_acquire_(&rb->head);
+    uint32_t idx   = tail & rb->mask;
+    uint32_t avail = head - tail;
+    uint32_t first = rb->size - idx;
+    uint32_t n     = (avail < first) ? avail : first;
+
+    if ((rb->flags & RBD_PRODUCER_DMA) != 0u && n != 0u) {
+        rbd_cache_op_(rb, idx, n, false);
+    }
+    *ptr = &rb->buf[idx];
+    return n;
+}
+
+/**
+ * @brief Consumer: hand @p n peeked bytes back to the producer.
+ *
+ * Release semantics: a DMB orders all reads of the region before the tail
+ * update, so the producer cannot overwrite bytes still being read.
+ */
+static inline void rbd_release(rbd_t *rb, uint32_t n)
+{
+    uint32_t tail = rb->tail;
+    RBD_DMB();
+    rb->tail = tail + n;
+}
+
+/**
+ * @brief Producer: copy up to @p n bytes in (CPU producer only).
+ *
+ * At most two memcpy() calls and one head publish.
+ *
+ * @return Number of bytes written.
+ */
+static inline uint32_t rbd_write(rbd_t *rb, const uint8_t *src, uint32_t n)
+{
+    uint32_t space = rbd_free(rb);
+    if (n > space) {
+        n = space;
+    }
+
+    uint32_t idx   = rb->head & rb->mask;
+    uint32_t first = rb->size - idx;
+    if (first > n) {
+        first = n;
+    }
+    memcpy(&rb->buf[idx], src, first);
+    memcpy(&rb->buf[0], src + first, n - first);
+
+    rbd_commit(rb, n);
+    return n;
+}
+
+/**
+ * @brief Consumer: copy up to @p n bytes out (CPU consumer only).
+ *
+ * At most two memcpy() calls and one tail publish.
+ *
+ * @return Number of bytes read.
+ */
+static inline uint32_t rbd_read(rbd_t *rb, uint8_t *dst, uint32_t n)
+{
+    uint32_t avail = rbd_count(rb);
+    if (n > avail) {
+        n = avail;
+    }
+
+    uint32_t idx   = rb->tail & rb->mask;
+    uint32_t first = rb->size - idx;
+    if (first > n) {
+        first = n;
+    }
+    if ((rb->flags & RBD_PRODUCER_DMA) != 0u && n != 0u) {
+        rbd_cache_op_(rb, idx, first, false);
+        if (n > first) {
+            rbd_cache_op_(rb, 0u, n - first, false);
+        }
+    }
+    memcpy(dst, &rb->buf[idx], first);
+    memcpy(dst + first, &rb->buf[0], n - first);
+
+    rbd_release(rb, n);
+    return n;
+}
+
+#endif /* RING_BUFFER_DMA_H */
@@ -0,0 +1,65 @@
+/**
+ * @file rtos_stats.h
+ * @brief Per-task CPU load and stack high-water marks (BRIDGE_RTOS_STATS=1,
+ *        the default; see FreeRTOSConfig.h).
+ *
+ * The kernel charges each task the DWT cycles of its time slices
+ * (configGENERATE_RUN_TIME_STATS).  Every RTOS_STATS_PERIOD_MS StatsTask
+ * takes a uxTaskGetSystemState() snapshot and turns it into g_rtos_stats:
+ * each task's share of the last period, its total cycles and the stack it
+ * has never touched.  Read the block with a debugger, or from any task.
+ *
+ * StatsTask runs above the bridge tasks so that a saturated bridge cannot
+ * starve it.  It wakes once per period and holds the scheduler for a few
+ * microseconds while the kernel scans the stacks.  The per-switch cost in
+ * the kernel is one CYCCNT read and one add.
+ */
+
+#ifndef RTOS_STATS_H
+#define RTOS_STATS_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* ---- Configuration -------------------------------------------------- */
+
+/** Snapshot interval; must stay well below the ~8.9 s CYCCNT wrap */
+#ifndef RTOS_STATS_PERIOD_MS
+#define RTOS_STATS_PERIOD_MS  1000u
+#endif
+
+/** Tasks tracked, in order of first appearance (idle task included) */
+#ifndef RTOS_STATS_MAX_TASKS
+#define RTOS_STATS_MAX_TASKS  8u
+#endif
+
+/* ---- Stats block ---------------------------------------------------- */
+
+typedef struct {
+    const char *name;        /**< Task name (NULL: slot unused) */
+    uint64_t    cycles;      /**< CPU cycles run since the scheduler started */
+    uint16_t    load;        /**< Share of the last period, ‰ */
+    uint16_t    stack_free;  /**< Stack words never used (high-water mark) */
+    uint8_t     priority;
+    uint8_t     state;       /**< eTaskState at the snapshot */
+} rtos_task_stats_t;
+
+typedef struct {
+    uint32_t          seq;     /**< Odd while a snapshot is being written */
+    uint32_t          period;  /**< Cycles covered by the last snapshot */
+    uint32_t          ntasks;  /**< Tasks in the system at the snapshot */
+    rtos_task_stats_t task[RTOS_STATS_MAX_TASKS];  /**< Fixed slot per task */
+} rtos_stats_t;
+
+/* ---- API ------------------------------------------------------------ */
+
+#if BRIDGE_RTOS_STATS
+extern rtos_stats_t g_rtos_stats;
+
+/**
+ * @brief StatsTask – refreshes g_rtos_stats every RTOS_STATS_PERIOD_MS.
+ */
+void StartStatsTask(void *argument);
+#endif /* BRIDGE_RTOS_STATS */
+
+#endif /* RTOS_STATS_H */
@@ -0,0 +1,144 @@
+/**
+ * @file rtos_trace.h
+ * @brief Context-switch and event trace ring (BRIDGE_RTOS_TRACE=1; see
+ *        FreeRTOSConfig.h).
+ *
+ * The FreeRTOS trace hooks write one 8-byte record per kernel event into
+ * g_rtos_trace, stamped with DWT CYCCNT:
+ *
+ *   RTOS_TRACE_SWITCH_IN   task starts running
+ *   RTOS_TRACE_SWITCH_OUT  task stops running; arg 1 if it is still ready
+ *                          (yield or preemption), 0 if it blocked
+ *   RTOS_TRACE_TICK        SysTick; arg = low 16 bits of the tick count
+ *   RTOS_TRACE_NOTIFY      the running task notifies task; arg = index
+ *   RTOS_TRACE_NOTIFY_ISR  an ISR notifies task; arg = exception number
+ *   RTOS_TRACE_WAIT        task blocks for a notification; arg = index
+ *
+ * Tasks are identified by the kernel's TCB number; the names are recorded
+ * in task[] when the tasks are created.  Every hook runs with interrupts
+ * masked up to configMAX_SYSCALL_INTERRUPT_PRIORITY (PendSV, SysTick or a
+ * kernel critical section), so there is one writer at a time and the ring
+ * needs no atomics.  A record costs about 15 cycles.
+ *
+ * The ring keeps the last RTOS_TRACE_LEN records.  Call rtos_trace_stop()
+ * (from code on the event of interest, or from the debugger), then dump
+ * the block and decode it with Firmware/Host/rtos_trace2json:
+ *
+ *   (gdb) call rtos_trace_stop()
+ *   (gdb) dump binary value trace.bin g_rtos_trace
+ *   $ ./rtos_trace2json trace.bin > trace.json
+ *
+ * The layout below is the dump format; the host tool reads it field by
+ * field (little-endian), so keep RTOS_TRACE_VERSION in step with it.
+ */
+
+#ifndef RTOS_TRACE_H
+#define RTOS_TRACE_H
+
+#include <stdint.h>
+#include "stm32h7xx.h"
+
+/* ---- Configuration -------------------------------------------------- */
+
+/** Set to 1 (with -D, as FreeRTOSConfig.h reads it) to record a trace */
+#ifndef BRIDGE_RTOS_TRACE
+#define BRIDGE_RTOS_TRACE    0
+#endif
+
+/** Records kept (power of two; 8 bytes each) */
+#ifndef RTOS_TRACE_LEN
+#define RTOS_TRACE_LEN       4096u
+#endif
+
+/** Task names kept */
+#ifndef RTOS_TRACE_MAX_TASKS
+#define RTOS_TRACE_MAX_TASKS 8u
+#endif
+
+#if (RTOS_TRACE_LEN & (RTOS_TRACE_LEN - 1u)) != 0u
+#error "RTOS_TRACE_LEN must be a power of two"
+#endif
+
+/* ---- Dump format ---------------------------------------------------- */
+
+#define RTOS_TRACE_MAGIC     0x46495452u   /**< "FITR" */
+#define RTOS_TRACE_VERSION   1u
+#define RTOS_TRACE_NAME_LEN  15u           /**< Including the NUL */
+
+enum {
+    RTOS_TRACE_SWITCH_IN  = 1,
+    RTOS_TRACE_SWITCH_OUT = 2,
+    RTOS_TRACE_TICK       = 3,
+    RTOS_TRACE_NOTIFY     = 4,
+    RTOS_TRACE_NOTIFY_ISR = 5,
+    RTOS_TRACE_WAIT       = 6,
+};
+
+typedef struct {
+    uint32_t cycles;  /**< DWT CYCCNT */
+    uint8_t  type;    /**< RTOS_TRACE_* */
+    uint8_t  task;    /**< TCB number of the task concerned */
+    uint16_t arg;
+} rtos_trace_rec_t;
+
+typedef struct {
+    uint8_t  id;                          /**< TCB number */
+    char     name[RTOS_TRACE_NAME_LEN];
+} rtos_trace_task_t;
+
+typedef struct {
+    uint32_t          magic;
+    uint16_t          version;
+    uint8_t           ntasks;     /**< Valid entries in task[] */
+    uint8_t           max_tasks;  /**< RTOS_TRACE_MAX_TASKS */
+    uint32_t          len;        /**< RTOS_TRACE_LEN */
+    uint32_t          core_hz;    /**< CYCCNT rate */
+    volatile uint32_t head;       /**< Records written so far (wraps) */
+    volatile uint32_t stop;       /**< Non-zero: recording stopped */
+    rtos_trace_task_t task[RTOS_TRACE_MAX_TASKS];
+    rtos_trace_rec_t  rec[RTOS_TRACE_LEN];
+} rtos_trace_t;
+
+/* ---- API ------------------------------------------------------------ */
+
+#if BRIDGE_RTOS_TRACE
+extern rtos_trace_t g_rtos_trace;
+
+/**
+ * @brief Clear the ring and start recording.  Call after the clock is
+ *        configured and before any task is created.
+ */
+void rtos_trace_init(void);
+
+/**
+ * @brief Stop recording and write the block back to RAM (D-cache clean),
+ *        so a debugger dump sees every record.
+ */
+void rtos_trace_stop(void);
+
+/**
+ * @brief Remember the name of task @p id (traceTASK_CREATE).
+ */
+void rtos_trace_task(uint32_t id, const char *name);
+
+/**
+ * @brief Append one record.
+ */
+static inline void rtos_trace_put(uint32_t type, uint32_t task, uint32_t arg)
+{
+    rtos_trace_t *t = &g_rtos_trace;
+
+    if (t->stop != 0u) {
+        return;
+    }
+
+    rtos_trace_rec_t *r = &t->rec[t->head & (RTOS_TRACE_LEN - 1u)];
+    r->cycles = DWT->CYCCNT;
+    r->type   = (uint8_t)type;
+    r->task   = (uint8_t)task;
+    r->arg    = (uint16_t)arg;
+    t->head++;
+}
+#endif /* BRIDGE_RTOS_TRACE */
+
+#endif /* RTOS_TRACE_H */
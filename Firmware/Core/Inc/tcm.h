@@ -0,0 +1,118 @@
+/**
+ * @file tcm.h
+ * @brief ITCM / DTCM placement of the bridge hot path on STM32H750.
+ *
+ * ITCM (64 KB at 0x00000000) and DTCM (128 KB at 0x20000000) run at CPU
+ * clock with no wait states and no cache, so code and data placed there
+ * never miss.  Flash and AXI-SRAM go through the I/D-caches instead.  Three
+ * switches select what moves, so each combination can be benchmarked
+ * (BRIDGE_PERF busy cycles, strobe late counts):
+ *
+ *   BRIDGE_ITCM_CODE  task loops and the strobe loops they inline
+ *   BRIDGE_DTCM_DATA  ring/queue control, strobe timing and statistics,
+ *                     lookup tables
+ *   BRIDGE_DTCM_BUF   ring buffer storage / block pool
+ *
+ * The sections are defined by Firmware/tcm_sections.ld, which has to be
+ * INCLUDEd in the CubeIDE linker script once any switch is set.  The
+ * startup code only handles .data and .bss; tcm_init() copies .itcm_text
+ * and .dtcm_data from flash and clears .dtcm_bss, and must run first thing
+ * in main().
+ *
+ * Calls from ITCM to flash (HAL, FreeRTOS) are out of BL range; GNU ld
+ * inserts long-branch veneers for them.  DMA1 cannot reach DTCM, so
+ * BRIDGE_DTCM_BUF excludes BRIDGE_READER_DMA.
+ */
+
+#ifndef TCM_H
+#define TCM_H
+
+#include <stdint.h>
+#include "stm32h7xx.h"
+
+/* ---- Configuration -------------------------------------------------- */
+
+#ifndef BRIDGE_ITCM_CODE
+#define BRIDGE_ITCM_CODE   0
+#endif
+
+#ifndef BRIDGE_DTCM_DATA
+#define BRIDGE_DTCM_DATA   0
+#endif
+
+#ifndef BRIDGE_DTCM_BUF
+#define BRIDGE_DTCM_BUF    0
+#endif
+
+#define BRIDGE_USE_TCM  (BRIDGE_ITCM_CODE || BRIDGE_DTCM_DATA || BRIDGE_DTCM_BUF)
+
+/* ---- Section attributes --------------------------------------------- */
+
+#define TCM_ITCM_TEXT  __attribute__((section(".itcm_text")))
+#define TCM_DTCM_DATA  __attribute__((section(".dtcm_data")))
+#define TCM_DTCM_CONST __attribute__((section(".dtcm_rodata")))
+#define TCM_DTCM_BSS   __attribute__((section(".dtcm_bss")))
+
+/** Hot functions (task loops, strobe loops) */
+#if BRIDGE_ITCM_CODE
+#define BRIDGE_HOT_CODE  TCM_ITCM_TEXT
+#else
+#define BRIDGE_HOT_CODE
+#endif
+
+/**
+ * Hot variables: BRIDGE_HOT_DATA if initialised, BRIDGE_HOT_BSS if not,
+ * BRIDGE_HOT_CONST for lookup tables (const objects need their own
+ * section; they are loaded along with .dtcm_data)
+ */
+#if BRIDGE_DTCM_DATA
+#define BRIDGE_HOT_DATA  TCM_DTCM_DATA
+#define BRIDGE_HOT_BSS   TCM_DTCM_BSS
+#define BRIDGE_HOT_CONST TCM_DTCM_CONST
+#else
+#define BRIDGE_HOT_DATA
+#define BRIDGE_HOT_BSS
+#define BRIDGE_HOT_CONST
+#endif
+
+/** Ring buffer storage / block pool */
+#if BRIDGE_DTCM_BUF
+#define BRIDGE_BUF_BSS   TCM_DTCM_BSS
+#else
+#define BRIDGE_BUF_BSS
+#endif
+
+/* ---- Startup -------------------------------------------------------- */
+
+#if BRIDGE_USE_TCM
+/* Defined in tcm_sections.ld */
+extern uint32_t _sitcm_text, _eitcm_text, _litcm_text;
+extern uint32_t _sdtcm_data, _edtcm_data, _ldtcm_data;
+extern uint32_t _sdtcm_bss,  _edtcm_bss;
+
+/**
+ * @brief Load the TCM sections.  Call before anything placed there is used.
+ */
+static inline void tcm_init(void)
+{
+    const uint32_t *src = &_litcm_text;
+    for (uint32_t *dst = &_sitcm_text; dst < &_eitcm_text; dst++) {
+        *dst = *src++;
+    }
+    src = &_ldtcm_data;
+    for (uint32_t *dst = &_sdtcm_data; dst < &_edtcm_data; dst++) {
+        *dst = *src++;
+    }
+    for (uint32_t *dst = &_sdtcm_bss; dst < &_edtcm_bss; dst++) {
+        *dst = 0u;
+    }
+
+    /* Code was written through the data side: make it visible to fetch */
+    __DSB();
+    __ISB();
+}
+#else
+static inline void tcm_init(void) {}
+#endif
+
+#endif /* TCM_H */
@@ -0,0 +1,227 @@
+/**
+ * @file fifo_blocks.c
+ * @brief Block-pipeline ReaderTask and WriterTask for the FT2232HL
+ *        245-Sync-FIFO bridge on STM32H750 DevEBox (BRIDGE_USE_BLOCKS=1).
+ *
+ * -------------------------------------------------------------------------
+ * Data flow:
+ *
+ *   ReaderTask takes an empty block from g_free_blocks, samples FIFO#1
+ *   straight into block->data[] and, once the block is full or RXF# goes
+ *   idle, stamps its length and hands it to WriterTask through
+ *   g_full_blocks.  WriterTask drives FIFO#2 from block->data[] and returns
+ *   the block to g_free_blocks once every byte has been accepted.
+ *
+ *   Only block pointers cross between the tasks; each block carries its
+ *   fill length and the DWT cycle count of its first byte.  WriterTask
+ *   turns the latter into g_block_latency, and later stages (CRC,
+ *   telemetry, DMA) can operate on whole blocks.
+ *
+ * Flow control mirrors fifo_bridge.c: a task with no block to work on
+ * publishes a "waiting" flag, re-checks its queue and blocks on a thread
+ * flag that the other side sets after queueing a block.  FIFO-side waits
+ * (RXF# / TXE#) sleep in fifo_exti_wait() until the pin's EXTI edge.
+ * -------------------------------------------------------------------------
+ */
+
+#include "fifo_bridge.h"
+#include "fifo_strobe.h"
+#include "fifo_exti.h"
+#include "fifo_crc.h"
+#include "cmsis_os.h"
+#include "dwt.h"
+
+#if BRIDGE_USE_BLOCKS
+
+block_latency_t g_block_latency BRIDGE_HOT_BSS;
+
+/* ---- Private helpers --------------------------------------------------- */
+
+/** Set by a task just before it blocks waiting for a block */
+static volatile bool s_reader_waiting BRIDGE_HOT_BSS;
+static volatile bool s_writer_waiting BRIDGE_HOT_BSS;
+
+/**
+ * @brief Block the calling task until @p q is non-empty.
+ */
+static void wait_for_block(blkq_t *q, volatile bool *waiting, uint32_t flag)
+{
+    *waiting = true;
+    __asm volatile ("" ::: "memory");
+    if (blkq_count(q) == 0u)
+    {
+        (void)osThreadFlagsWait(flag, osFlagsWaitAny, osWaitForever);
+    }
+    *waiting = false;
+}
+
+/**
+ * @brief Queue @p blk on @p q and wake the consumer if it is waiting.
+ */
+static void hand_over(blkq_t *q, block_t *blk, volatile bool *waiting,
+                      osThreadId_t thread, uint32_t flag)
+{
+    /* Cannot fail: the queue is deeper than the pool */
+    (void)blkq_push(q, blk);
+    if (*waiting)
+    {
+        *waiting = false;
+        (void)osThreadFlagsSet(thread, flag);
+    }
+}
+
+/**
+ * @brief Account the latency of @p blk, whose first byte goes out at
+ *        @p now.
+ */
+static void block_latency(const block_t *blk, uint32_t now)
+{
+    block_latency_t *l   = &g_block_latency;
+    uint32_t         lat = now - blk->timestamp;
+
+    l->sum += lat;
+    l->last = lat;
+    if (lat > l->max)
+    {
+        l->max = lat;
+    }
+    l->blocks++;
+}
+
+/* ======================================================================== */
+/**
+ * @brief ReaderTask – fills blocks from FIFO#1 (FT2232HL Channel A, PC→MCU).
+ *
+ * A partially filled block is handed over as soon as RXF# goes idle, so a
+ * short transfer is not held back waiting for the block to fill.
+ */
+BRIDGE_HOT_CODE void StartReaderTask(void *argument)
+{
+    (void)argument;
+
+    block_t *blk = NULL;
+
+    for (;;)
+    {
+        /* Get an empty block to fill */
+        if (blk == NULL)
+        {
+            blk = blkq_pop(&g_free_blocks);
+            if (blk == NULL)
+            {
+                wait_for_block(&g_free_blocks, &s_reader_waiting,
+                               BRIDGE_FLAG_SPACE);
+                continue;
+            }
+            blk->len = 0u;
+        }
+
+        /* Wait for data to be available in FIFO#1 (bus released meanwhile) */
+        if (!FIFO1_RXF_ACTIVE())
+        {
+            FIFO1_OE_DEASSERT();
+            if (blk->len != 0u)
+            {
+                hand_over(&g_full_blocks, blk, &s_writer_waiting,
+                          g_writer_thread, BRIDGE_FLAG_DATA);
+                blk = NULL;
+            }
+            fifo_exti_wait(FIFO_EXTI_RXF);
+            continue;
+        }
+
+        if (blk->len == 0u)
+        {
+            blk->timestamp = dwt_cycles();
+        }
+
+        /* CLKOUT-timed burst into the block (OE# is asserted by the burst
+         * and stays so while FIFO#1 has data) */
+        uint32_t n   = blk->len;
+        uint32_t end = n + BRIDGE_BURST_LEN;
+        if (end > BLOCK_DATA_SIZE)
+        {
+            end = BLOCK_DATA_SIZE;
+        }
+        uint32_t got = fifo1_strobe_read(&blk->data[n], end - n);
+        fifo_crc_rx(&blk->data[n], got);
+        n += got;
+        blk->len = n;
+
+        /* Hand over a full block, or a partial one when FIFO#1 ran dry */
+        if (n == BLOCK_DATA_SIZE || n < end)
+        {
+            hand_over(&g_full_blocks, blk, &s_writer_waiting,
+                      g_writer_thread, BRIDGE_FLAG_DATA);
+            blk = NULL;
+        }
+
+        osThreadYield();
+    }
+}
+
+/* ======================================================================== */
+/**
+ * @brief WriterTask – drains filled blocks to FIFO#2 (FT2232HL Channel A,
+ *        MCU→PC) and recycles them.
+ *
+ * The first burst of a block that FIFO#2 accepts records the block's
+ * latency in g_block_latency.
+ */
+BRIDGE_HOT_CODE void StartWriterTask(void *argument)
+{
+    (void)argument;
+
+    block_t *blk = NULL;
+    uint32_t pos = 0u;
+
+    for (;;)
+    {
+        /* Get a filled block to send */
+        if (blk == NULL)
+        {
+            blk = blkq_pop(&g_full_blocks);
+            pos = 0u;
+            if (blk == NULL)
+            {
+                wait_for_block(&g_full_blocks, &s_writer_waiting,
+                               BRIDGE_FLAG_DATA);
+                continue;
+            }
+        }
+
+        /* Wait for space in FIFO#2 */
+        if (!FIFO2_TXE_ACTIVE())
+        {
+            fifo_exti_wait(FIFO_EXTI_TXE);
+            continue;
+        }
+
+        /* Burst-write while the block has data and FIFO#2 can accept */
+        uint32_t end = pos + BRIDGE_BURST_LEN;
+        if (end > blk->len)
+        {
+            end = blk->len;
+        }
+        uint32_t t0   = dwt_cycles();
+        uint32_t sent = fifo2_strobe_write(&blk->data[pos], end - pos);
+        if (pos == 0u && sent != 0u)
+        {
+            block_latency(blk, t0);
+        }
+        fifo_crc_tx(&blk->data[pos], sent);
+        pos += sent;
+
+        /* Recycle the block once fully sent */
+        if (pos == blk->len)
+        {
+            hand_over(&g_free_blocks, blk, &s_reader_waiting,
+                      g_reader_thread, BRIDGE_FLAG_SPACE);
+            blk = NULL;
+        }
+
+        osThreadYield();
+    }
+}
+
+#endif /* BRIDGE_USE_BLOCKS */
@@ -1,34 +1,50 @@
 /**
  * @file fifo_bridge.c
- * @brief FreeRTOS ReaderTask and WriterTask for the FT2232HL 245-Sync-FIFO
- *        bridge on STM32H750 DevEBox.
+ * @brief FreeRTOS ReaderTask and WriterTask (or the single BridgeTask) for
+ *        the FT2232HL 245-Sync-FIFO bridge on STM32H750 DevEBox.
  *
  * -------------------------------------------------------------------------
  * 245 Synchronous FIFO read protocol (FIFO#1, FT2232HL → MCU):
  *
  *   1. Assert OE# low  (MCU takes bus ownership)
  *   2. Wait until RXF# goes low (data available)
- *   3. Assert RD# low  (latch byte on next rising CLKOUT edge inside FT chip)
- *   4. Sample data bus after one CLKOUT period (≈16 ns @ 60 MHz)
- *   5. Deassert RD# high (one CLKOUT period between consecutive reads is fine)
- *   6. Repeat from step 2, or deassert OE# when done
+ *   3. Sample the data bus; RD# low at the next rising CLKOUT edge
+ *      consumes that byte and presents the next one
+ *   4. Repeat from step 3 while RXF# stays low (RD# may stay low: one
+ *      byte per CLKOUT period)
+ *   5. Deassert RD#; deassert OE# once FIFO#1 goes idle
  *
  * Because the STM32H750 runs at 480 MHz and CLKOUT is 60 MHz the MCU sees
- * each CLKOUT period as ~8 CPU cycles.  A small __NOP() delay after asserting
- * RD# is sufficient to satisfy the setup time without using a timer.
+ * each CLKOUT period as 8 CPU cycles.  fifo_strobe.h locks onto a CLKOUT
+ * edge per burst and times every access with the DWT cycle counter.
  *
  * 245 Synchronous FIFO write protocol (FIFO#2, MCU → FT2232HL):
  *
  *   1. Wait until TXE# goes low (transmit buffer not full)
- *   2. Drive data onto PF[7:0]
- *   3. Assert WR# low for ≥1 CLKOUT period
- *   4. Deassert WR# high
- *   5. Repeat from step 1
+ *   2. Drive data onto PF[7:0] and WR# low ≥8 ns before a CLKOUT edge
+ *   3. The edge takes the byte if TXE# is still low
+ *   4. Repeat from step 2 (WR# may stay low: one byte per CLKOUT period)
+ *   5. Deassert WR# high
+ *
+ * -------------------------------------------------------------------------
+ * Flow control:
+ *   A task that finds the ring buffer empty (WriterTask) or full
+ *   (ReaderTask) blocks on a thread flag instead of yield-spinning.  The
+ *   other side sets the flag once occupancy reaches BRIDGE_WRITER_WAKE_FILL
+ *   (data for WriterTask) or drops to BRIDGE_READER_WAKE_FILL (space for
+ *   ReaderTask).  Each sleeper publishes a "waiting" flag and then re-checks
+ *   the condition before blocking; thread flags latch, so a notification
+ *   sent between the re-check and the wait is not lost.  Waiting for FIFO#1
+ *   data (RXF#) or FIFO#2 space (TXE#) sleeps in fifo_exti_wait() until
+ *   the pin's EXTI edge (see fifo_exti.h).  With BRIDGE_SINGLE_TASK both
+ *   legs run in BridgeTask and none of this is needed.
  *
  * -------------------------------------------------------------------------
  * Cache note (STM32H7):
- *   The ring buffer (g_bridge_buf) is in AXI-SRAM and is accessed only by the
- *   CPU.  The Cortex-M7 hardware manages coherency automatically.  No explicit
+ *   The ring buffer (g_bridge_buf) is in AXI-SRAM and, unless
+ *   BRIDGE_READER_DMA is set (see fifo_dma.c), is accessed only by the
+ *   CPU (the BRIDGE_WRITER_DMA leg reads its own staging array).  The
+ *   Cortex-M7 hardware manages coherency automatically.  No explicit
  *   cache maintenance (SCB_CleanDCache / SCB_InvalidateDCache) is required
  *   here.  A compiler memory barrier (__asm volatile("" ::: "memory")) in
  *   ring_buffer.h is sufficient to prevent the compiler from reordering
@@ -37,15 +53,228 @@
  */
 
 #include "fifo_bridge.h"
+#include "fifo_dma.h"
+#include "fifo_strobe.h"
+#include "fifo_exti.h"
+#include "fifo_crc.h"
+#include "fifo_tele.h"
 #include "cmsis_os.h"
 
+#if !BRIDGE_USE_BLOCKS  /* block pipeline lives in fifo_blocks.c */
+
+/* ---- Burst profiling --------------------------------------------------- */
+
+#if BRIDGE_PERF
+bridge_perf_t g_bridge_perf BRIDGE_HOT_BSS;
+
+static inline uint32_t perf_stamp(void)
+{
+    return dwt_cycles();
+}
+
+/**
+ * @brief Account one burst of @p leg that started at @p t0 and moved @p n
+ *        bytes; @p full if it stopped at its length limit.
+ */
+BRIDGE_HOT_CODE static void perf_burst(uint32_t leg, uint32_t t0,
+                                       uint32_t n, bool full)
+{
+    bridge_leg_perf_t *p  = &g_bridge_perf.leg[leg];
+    uint32_t           t1 = dwt_cycles();
+
+    if (n == 0u)
+    {
+        return;
+    }
+    if (p->bursts != 0u)
+    {
+        p->cycles += t1 - p->last_end;
+        if (p->last_full)
+        {
+            uint32_t gap = t0 - p->last_end;
+            p->gap_sum += gap;
+            p->gaps++;
+            if (gap > p->gap_max)
+            {
+                p->gap_max = gap;
+            }
+        }
+    }
+    p->busy     += t1 - t0;
+    p->bytes    += n;
+    p->bursts++;
+    p->last_end  = t1;
+    p->last_full = full;
+}
+#else
+static inline uint32_t perf_stamp(void)
+{
+    return 0u;
+}
+
+static inline void perf_burst(uint32_t leg, uint32_t t0, uint32_t n,
+                              bool full)
+{
+    (void)leg; (void)t0; (void)n; (void)full;
+}
+#endif /* BRIDGE_PERF */
+
+#if BRIDGE_SINGLE_TASK
+/* ======================================================================== */
+/**
+ * @brief BridgeTask – moves bytes FIFO#1 → ring buffer → FIFO#2 on its own
+ *        (BRIDGE_SINGLE_TASK=1).
+ *
+ * Each pass runs at most one read burst and one write burst of up to
+ * BRIDGE_BURST_LEN bytes, so neither leg can starve the other for longer
+ * than one burst.  The ring buffer still decouples the legs (FIFO#2 may
+ * stall while FIFO#1 keeps delivering), but both ends are in this task:
+ * there are no watermarks, no thread flags, and no context switch between
+ * a read and the write that follows it.
+ *
+ * When neither leg could move a byte the task sleeps in fifo_exti_wait()
+ * on whichever edges can unblock it: RXF# if the ring buffer has room,
+ * TXE# if it holds data.
+ */
+BRIDGE_HOT_CODE void StartBridgeTask(void *argument)
+{
+    (void)argument;
+
+    for (;;)
+    {
+        bool moved = false;
+
+        /* Read leg: FIFO#1 → ring buffer */
+        uint8_t *dst;
+        uint32_t space = rb_reserve(&g_bridge_buf, &dst);
+        if (!FIFO1_RXF_ACTIVE())
+        {
+            /* FIFO#1 idle: release the bus until data arrives again */
+            FIFO1_OE_DEASSERT();
+        }
+        else if (space != 0u)
+        {
+            if (space > BRIDGE_BURST_LEN)
+            {
+                space = BRIDGE_BURST_LEN;
+            }
+            uint32_t t0 = perf_stamp();
+            uint32_t n  = fifo1_strobe_read(dst, space);
+            rb_commit(&g_bridge_buf, n);
+            perf_burst(0u, t0, n, n == space);
+            fifo_crc_rx(dst, n);
+            fifo_tele_rx(n);
+            moved = n != 0u;
+        }
+        else
+        {
+            fifo_tele_ring_full();
+        }
+
+        /* Write leg: a due telemetry frame, then ring buffer → FIFO#2 */
+        bool           tele = fifo_tele_send();
+        const uint8_t *src;
+        uint32_t avail = rb_peek(&g_bridge_buf, &src);
+        if (tele)
+        {
+            /* Frame still unsent: FIFO#2 is full */
+        }
+        else if (avail != 0u && FIFO2_TXE_ACTIVE())
+        {
+            if (avail > BRIDGE_BURST_LEN)
+            {
+                avail = BRIDGE_BURST_LEN;
+            }
+
+            uint32_t t0 = perf_stamp();
+            uint32_t n  = fifo2_strobe_write(src, avail);
+            perf_burst(1u, t0, n, n == avail);
+            fifo_crc_tx(src, n);
+            fifo_tele_tx(src, n);
+            rb_release(&g_bridge_buf, n);
+            moved = moved || n != 0u;
+        }
+        else if (avail != 0u)
+        {
+            fifo_tele_fifo2_full();
+        }
+
+        if (!moved)
+        {
+            fifo_exti_wait((space != 0u ? FIFO_EXTI_RXF : 0u) |
+                           (avail != 0u || tele ? FIFO_EXTI_TXE : 0u));
+        }
+    }
+}
+
+#else /* !BRIDGE_SINGLE_TASK */
+
 /* ---- Private helpers --------------------------------------------------- */
 
-/** Tiny busy-wait: ~N * 2 CPU cycles at any optimisation level */
-static inline void delay_cycles(uint32_t n)
+/** Set by a task just before it blocks on its watermark flag */
+static volatile bool s_reader_waiting BRIDGE_HOT_BSS;
+static volatile bool s_writer_waiting BRIDGE_HOT_BSS;
+
+/**
+ * @brief Block WriterTask until the buffer holds data, or until the next
+ *        telemetry frame is due.
+ */
+static void writer_wait_for_data(void)
+{
+    s_writer_waiting = true;
+    __asm volatile ("" ::: "memory");
+    if (rb_empty(&g_bridge_buf))
+    {
+        (void)osThreadFlagsWait(BRIDGE_FLAG_DATA, osFlagsWaitAny,
+                                fifo_tele_idle_wait());
+    }
+    s_writer_waiting = false;
+}
+
+/**
+ * @brief Block ReaderTask until the buffer has drained to
+ *        BRIDGE_READER_WAKE_FILL.
+ */
+static void reader_wait_for_space(void)
+{
+    s_reader_waiting = true;
+    __asm volatile ("" ::: "memory");
+    if (rb_count(&g_bridge_buf) > BRIDGE_READER_WAKE_FILL)
+    {
+        (void)osThreadFlagsWait(BRIDGE_FLAG_SPACE, osFlagsWaitAny,
+                                osWaitForever);
+    }
+    s_reader_waiting = false;
+}
+
+/**
+ * @brief Called by ReaderTask after a commit: wake WriterTask once
+ *        BRIDGE_WRITER_WAKE_FILL is reached, or unconditionally when FIFO#1
+ *        went idle so a short tail of data is not left waiting.
+ */
+static void reader_notify(bool fifo_idle)
+{
+    if (!s_writer_waiting || rb_empty(&g_bridge_buf))
+    {
+        return;
+    }
+    if (fifo_idle || rb_count(&g_bridge_buf) >= BRIDGE_WRITER_WAKE_FILL)
+    {
+        s_writer_waiting = false;
+        (void)osThreadFlagsSet(g_writer_thread, BRIDGE_FLAG_DATA);
+    }
+}
+
+/**
+ * @brief Called by WriterTask after a release: wake ReaderTask once the
+ *        occupancy has dropped to BRIDGE_READER_WAKE_FILL.
+ */
+static void writer_notify(void)
 {
-    while (n--) {
-        __asm volatile ("nop");
+    if (s_reader_waiting && rb_count(&g_bridge_buf) <= BRIDGE_READER_WAKE_FILL)
+    {
+        s_reader_waiting = false;
+        (void)osThreadFlagsSet(g_reader_thread, BRIDGE_FLAG_SPACE);
     }
 }
 
@@ -54,50 +283,74 @@ static inline void delay_cycles(uint32_t n)
  * @brief ReaderTask – reads bytes from FIFO#1 (FT2232HL Channel A, PC→MCU)
  *        and pushes them into the shared ring buffer.
  *
- * The task yields to the scheduler (osThreadYield) when either:
- *   - RXF# is not active (no data in the FT2232HL receive FIFO), or
- *   - The ring buffer is full (back-pressure from WriterTask).
+ * The task sleeps until the RXF# edge (fifo_exti_wait) when RXF# is not
+ * active (no data in the FT2232HL receive FIFO), and blocks until
+ * occupancy drops to BRIDGE_READER_WAKE_FILL when the ring buffer is full
+ * (back-pressure from WriterTask).
+ *
+ * Bytes are sampled by fifo1_strobe_read() straight into ring buffer
+ * memory obtained with rb_reserve() and published with one rb_commit()
+ * per burst, so there is no intermediate copy and the head update is paid
+ * once per burst.  With BRIDGE_READER_DMA the same region is handed to
+ * fifo1_dma_read() instead and the task sleeps while DMA fills it.
  */
-void StartReaderTask(void *argument)
+BRIDGE_HOT_CODE void StartReaderTask(void *argument)
 {
     (void)argument;
 
     for (;;)
     {
         /* Wait for data to be available in FIFO#1 */
-        if (!FIFO1_RXF_ACTIVE() || rb_full(&g_bridge_buf))
+        uint8_t *dst;
+        uint32_t space = rb_reserve(&g_bridge_buf, &dst);
+        if (space == 0u)
         {
-            osThreadYield();
+            fifo_tele_ring_full();
+            reader_wait_for_space();
             continue;
         }
 
-        /* Assert OE# to enable FT2232HL output drivers */
-        FIFO1_OE_ASSERT();
-        delay_cycles(2); /* setup time: ≥1 CLKOUT period */
-
-        /* Burst-read while data available and ring buffer has space */
-        while (FIFO1_RXF_ACTIVE() && !rb_full(&g_bridge_buf))
+#if BRIDGE_READER_DMA
+        /* TIM2 + DMA1 run the strobes; sleep until the chunk is complete or
+         * FIFO#1 runs dry */
+        if (space > FIFO1_DMA_CHUNK)
         {
-            /* Assert RD# – FT2232HL latches IDR on next rising CLKOUT */
-            FIFO1_RD_ASSERT();
-            delay_cycles(4); /* ≥1 CLKOUT period @ 60 MHz = ~8 CPU cycles */
-
-            /* Sample data bus */
-            uint8_t byte = FIFO1_READ_DATA();
-
-            /* Deassert RD# */
-            FIFO1_RD_DEASSERT();
-            delay_cycles(2);
-
-            /* Push to ring buffer (cannot fail: checked rb_full above) */
-            rb_push(&g_bridge_buf, byte);
+            space = FIFO1_DMA_CHUNK;
         }
+        uint32_t n = fifo1_dma_read(dst, space);
+        rb_commit(&g_bridge_buf, n);
+        reader_notify(n < space);
+        fifo_crc_rx(dst, n);
+        fifo_tele_rx(n);
+#else
+        if (!FIFO1_RXF_ACTIVE())
+        {
+            /* FIFO#1 idle: release the bus until data arrives again */
+            FIFO1_OE_DEASSERT();
+            reader_notify(true);
+            fifo_exti_wait(FIFO_EXTI_RXF);
+            continue;
+        }
+        if (space > BRIDGE_BURST_LEN)
+        {
+            space = BRIDGE_BURST_LEN;
+        }
+
+        /* CLKOUT-timed burst straight into the reserved region (OE# is
+         * asserted by the burst and stays so while FIFO#1 has data) */
+        uint32_t t0 = perf_stamp();
+        uint32_t n  = fifo1_strobe_read(dst, space);
 
-        /* Deassert OE# to release bus */
-        FIFO1_OE_DEASSERT();
+        /* Publish the burst and wake WriterTask if warranted */
+        rb_commit(&g_bridge_buf, n);
+        perf_burst(0u, t0, n, n == space);
+        reader_notify(n < space);
+        fifo_crc_rx(dst, n);
+        fifo_tele_rx(n);
 
         /* Yield to let WriterTask drain the buffer */
         osThreadYield();
+#endif /* BRIDGE_READER_DMA */
     }
 }
 
@@ -106,40 +359,101 @@ void StartReaderTask(void *argument)
  * @brief WriterTask – pops bytes from the shared ring buffer and writes them
  *        to FIFO#2 (FT2232HL Channel A, MCU→PC).
  *
- * The task yields when either:
- *   - The ring buffer is empty (nothing to send), or
- *   - TXE# is not active (FIFO#2 transmit buffer is full).
+ * The task blocks until ReaderTask signals data when the ring buffer is
+ * empty, and sleeps until the TXE# edge when TXE# is not active (FIFO#2
+ * transmit buffer is full).
+ *
+ * Bytes are driven straight from ring buffer memory obtained with
+ * rb_peek() by fifo2_strobe_write(), one 32-bit load per four bytes; only
+ * the bytes actually accepted by FIFO#2 are handed back with one
+ * rb_release() per burst, so a word cut short by TXE# is simply re-read on
+ * the next burst.  With BRIDGE_WRITER_DMA the peeked region is handed to
+ * fifo2_dma_write() instead and released the same way.
  */
-void StartWriterTask(void *argument)
+BRIDGE_HOT_CODE void StartWriterTask(void *argument)
 {
     (void)argument;
 
     for (;;)
     {
+        /* A due telemetry frame goes out before any more stream bytes */
+        if (fifo_tele_send())
+        {
+#if !BRIDGE_WRITER_DMA
+            fifo_tele_fifo2_full();
+            fifo_exti_wait(FIFO_EXTI_TXE);
+#endif
+            continue;
+        }
+
         /* Wait for data in ring buffer and space in FIFO#2 */
-        if (rb_empty(&g_bridge_buf) || !FIFO2_TXE_ACTIVE())
+        const uint8_t *src;
+        uint32_t avail = rb_peek(&g_bridge_buf, &src);
+        if (avail == 0u)
         {
-            osThreadYield();
+            writer_wait_for_data();
             continue;
         }
 
-        /* Burst-write while ring buffer has data and FIFO#2 can accept */
-        while (!rb_empty(&g_bridge_buf) && FIFO2_TXE_ACTIVE())
+#if BRIDGE_WRITER_DMA
+        /* TIM8 + DMA1 drive the bus; bytes FIFO#2 did not take stay in the
+         * ring buffer and are staged again on the next pass */
+        if (avail > FIFO2_DMA_CHUNK)
+        {
+            avail = FIFO2_DMA_CHUNK;
+        }
+        uint32_t n = fifo2_dma_write(src, avail);
+        if (n < avail)
+        {
+            fifo_tele_fifo2_full();
+        }
+        fifo_crc_tx(src, n);
+        fifo_tele_tx(src, n);
+        rb_release(&g_bridge_buf, n);
+        writer_notify();
+#else
+        if (!FIFO2_TXE_ACTIVE())
         {
-            uint8_t byte;
-            rb_pop(&g_bridge_buf, &byte);
+            fifo_tele_fifo2_full();
+            fifo_exti_wait(FIFO_EXTI_TXE);
+            continue;
+        }
+        if (avail > BRIDGE_BURST_LEN)
+        {
+            avail = BRIDGE_BURST_LEN;
+        }
 
-            /* Drive data bus */
-            FIFO2_WRITE_DATA(byte);
-            delay_cycles(2); /* data setup time */
+        /* CLKOUT-timed burst straight from ring buffer memory */
+        uint32_t t0 = perf_stamp();
+        uint32_t n  = fifo2_strobe_write(src, avail);
 
-            /* Pulse WR# low for ≥1 CLKOUT period */
-            FIFO2_WR_ASSERT();
-            delay_cycles(4);
-            FIFO2_WR_DEASSERT();
-            delay_cycles(2); /* WR# high time before next cycle */
-        }
+        /* Check the sent bytes, then hand them back to ReaderTask */
+        perf_burst(1u, t0, n, n == avail);
+        fifo_crc_tx(src, n);
+        fifo_tele_tx(src, n);
+        rb_release(&g_bridge_buf, n);
+        writer_notify();
 
         osThreadYield();
+#endif /* BRIDGE_WRITER_DMA */
     }
 }
+
+#endif /* BRIDGE_SINGLE_TASK */
+
+#if RB_ENABLE_STATS
+/* ======================================================================== */
+/**
+ * @brief Export the bridge ring buffer statistics.
+ *
+ * peak / hist[] tell how much of BRIDGE_BUF_SIZE is actually used;
+ * full_events counts ReaderTask stalls (receiver leg is the bottleneck),
+ * empty_events counts WriterTask stalls (sender leg is the bottleneck).
+ */
+void bridge_get_buf_stats(rb_stats_t *out)
+{
+    rb_stats_get(&g_bridge_buf, out);
+}
+#endif
+
+#endif /* !BRIDGE_USE_BLOCKS */
@@ -0,0 +1,30 @@
+/**
+ * @file fifo_bsrr.c
+ * @brief FIFO#2 output lookup table: the PF[7:0] BSRR word for every byte
+ *        value (see FIFO2_BSRR() in fifo_bridge.h).
+ *
+ * The table is expanded by the preprocessor from FIFO2_BSRR_WORD(), so it
+ * is a compile-time constant and always agrees with the macro.  The CPU
+ * write loop stores one entry per byte, and the DMA write leg copies
+ * entries into its staging array.  With BRIDGE_DTCM_DATA it is loaded into
+ * DTCM by tcm_init(); otherwise it stays in flash behind the D-cache
+ * (1 KB).
+ */
+
+#include "fifo_bridge.h"
+
+#if BRIDGE_BSRR_LUT
+
+#define BSRR_1(b)    FIFO2_BSRR_WORD(b)
+#define BSRR_4(b)    BSRR_1(b), BSRR_1((b) + 1u), \
+                     BSRR_1((b) + 2u), BSRR_1((b) + 3u)
+#define BSRR_16(b)   BSRR_4(b), BSRR_4((b) + 4u), \
+                     BSRR_4((b) + 8u), BSRR_4((b) + 12u)
+#define BSRR_64(b)   BSRR_16(b), BSRR_16((b) + 16u), \
+                     BSRR_16((b) + 32u), BSRR_16((b) + 48u)
+#define BSRR_256(b)  BSRR_64(b), BSRR_64((b) + 64u), \
+                     BSRR_64((b) + 128u), BSRR_64((b) + 192u)
+
+const uint32_t g_fifo2_bsrr_lut[256] BRIDGE_HOT_CONST = { BSRR_256(0u) };
+
+#endif /* BRIDGE_BSRR_LUT */
@@ -0,0 +1,340 @@
+/**
+ * @file fifo_calib.c
+ * @brief Boot-time CLKOUT measurement and strobe timing calibration (see
+ *        fifo_calib.h).
+ *
+ * Everything here runs once, before the scheduler starts.  Each
+ * measurement masks interrupts so the HAL tick cannot land between two
+ * timestamps.
+ */
+
+#include "fifo_calib.h"
+#include "prbs.h"
+
+fifo_calib_t g_fifo_calib;
+
+/* ---- Private helpers --------------------------------------------------- */
+
+/** Period measurement: CALIB_SPANS spans of CALIB_SPAN CLKOUT periods */
+#define CALIB_SPAN       256u
+#define CALIB_SPANS      8u
+
+/**
+ * @brief Picoseconds → CPU cycles at SystemCoreClock, rounded up.
+ */
+static uint32_t ps_to_cycles(uint32_t ps)
+{
+    return (uint32_t)(((uint64_t)ps * SystemCoreClock + 999999999999ull) /
+                      1000000000000ull);
+}
+
+/**
+ * @brief Like strobe_sync(), but report whether an edge was actually seen.
+ */
+static bool lock_edge(GPIO_TypeDef *port, uint32_t pin, uint32_t *t)
+{
+    uint32_t spins = STROBE_SYNC_SPINS;
+    while ((port->IDR & pin) != 0u && --spins != 0u) {}
+    while ((port->IDR & pin) == 0u && --spins != 0u) {}
+    *t = dwt_cycles();
+    return spins != 0u;
+}
+
+/**
+ * @brief Worst GPIO write → IDR read-back latency, measured on FIFO#1 OE#.
+ *
+ * Toggling OE# with RD# high only switches the FT2232H's data drivers, so
+ * it is harmless at boot.  Both control ports sit on AHB4 and share the
+ * figure.
+ */
+static uint32_t measure_roundtrip(void)
+{
+    uint32_t worst = 0u;
+
+    for (uint32_t i = 0u; i < CALIB_ROUNDTRIPS; i++)
+    {
+        uint32_t spins = STROBE_SYNC_SPINS;
+        uint32_t t0    = dwt_cycles();
+        FIFO1_OE_ASSERT();
+        while ((FIFO1_CTRL_PORT->IDR & FIFO1_OE_PIN) != 0u &&
+               --spins != 0u) {}
+        uint32_t dt = dwt_cycles() - t0;
+
+        FIFO1_OE_DEASSERT();
+        spins = STROBE_SYNC_SPINS;
+        while ((FIFO1_CTRL_PORT->IDR & FIFO1_OE_PIN) == 0u &&
+               --spins != 0u) {}
+
+        if (dt > worst)
+        {
+            worst = dt;
+        }
+    }
+    return worst;
+}
+
+/**
+ * @brief Measure the CLKOUT period from edge timestamps.
+ *
+ * First a gross check: back-to-back locks are one period apart, give or
+ * take the lock uncertainty, which catches a missing or wrong clock.  Then
+ * CALIB_SPANS spans of CALIB_SPAN periods each: the edge count of a span
+ * is rounded from the nominal period (the FT2232H and HSE crystals agree
+ * to ~100 ppm, far below the half period that would mis-round 256 edges),
+ * and the period is total time over total edges.
+ *
+ * @return Period in cycles × 256, or 0 if CLKOUT is missing or far off.
+ */
+static uint32_t measure_period_q8(GPIO_TypeDef *port, uint32_t pin,
+                                  uint32_t nominal_q8)
+{
+    uint32_t a, b;
+    uint32_t coarse = 0u;
+
+    for (uint32_t i = 0u; i < CALIB_SPANS; i++)
+    {
+        if (!lock_edge(port, pin, &a) || !lock_edge(port, pin, &b))
+        {
+            return 0u;
+        }
+        coarse += b - a;
+    }
+    uint32_t coarse_q8 = (coarse << 8) / CALIB_SPANS;
+    if (coarse_q8 * 4u < nominal_q8 * 3u || coarse_q8 * 4u > nominal_q8 * 5u)
+    {
+        return 0u;
+    }
+
+    uint64_t total_q8 = 0u;
+    uint32_t edges    = 0u;
+    for (uint32_t i = 0u; i < CALIB_SPANS; i++)
+    {
+        if (!lock_edge(port, pin, &a))
+        {
+            return 0u;
+        }
+        dwt_wait_until(a + ((CALIB_SPAN * nominal_q8) >> 8));
+        if (!lock_edge(port, pin, &b))
+        {
+            return 0u;
+        }
+        uint64_t d_q8 = (uint64_t)(b - a) << 8;
+        total_q8 += d_q8;
+        edges    += (uint32_t)((d_q8 + nominal_q8 / 2u) / nominal_q8);
+    }
+    return (uint32_t)((total_q8 + edges / 2u) / edges);
+}
+
+/**
+ * @brief Phase spread of the edge lock: lock CALIB_SYNCS times at staggered
+ *        moments and find the shortest arc of the period holding all
+ *        timestamps.
+ */
+static uint32_t measure_spread_q8(GPIO_TypeDef *port, uint32_t pin,
+                                  uint32_t period_q8)
+{
+    uint32_t phase[CALIB_SYNCS];
+    uint32_t t0;
+
+    (void)lock_edge(port, pin, &t0);
+    for (uint32_t i = 0u; i < CALIB_SYNCS; i++)
+    {
+        uint32_t t;
+        dwt_wait_until(dwt_cycles() + (i * 37u) % 64u);
+        (void)lock_edge(port, pin, &t);
+        uint32_t p = (uint32_t)(((uint64_t)(t - t0) << 8) % period_q8);
+
+        /* Insertion sort, the array is tiny */
+        uint32_t j = i;
+        while (j > 0u && phase[j - 1u] > p)
+        {
+            phase[j] = phase[j - 1u];
+            j--;
+        }
+        phase[j] = p;
+    }
+
+    uint32_t max_gap = phase[0] + period_q8 - phase[CALIB_SYNCS - 1u];
+    for (uint32_t i = 1u; i < CALIB_SYNCS; i++)
+    {
+        uint32_t gap = phase[i] - phase[i - 1u];
+        if (gap > max_gap)
+        {
+            max_gap = gap;
+        }
+    }
+    return period_q8 - max_gap;
+}
+
+/**
+ * @brief Measure one leg and, if the result can be scheduled, apply it;
+ *        otherwise fall back to pulsed default timing.
+ */
+static void calibrate_leg(fifo_calib_leg_t *res, strobe_timing_t *timing,
+                          GPIO_TypeDef *port, uint32_t clk_pin)
+{
+    uint32_t nominal_q8 = (uint32_t)(((uint64_t)SystemCoreClock << 8) /
+                                     FT_CLKOUT_HZ);
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint32_t period_q8 = measure_period_q8(port, clk_pin, nominal_q8);
+    res->clk_ok = period_q8 != 0u;
+    if (!res->clk_ok)
+    {
+        period_q8 = nominal_q8;
+    }
+    res->period_q8 = period_q8;
+    res->clk_hz    = (uint32_t)(((uint64_t)SystemCoreClock << 8) / period_q8);
+    res->spread_q8 = res->clk_ok ? measure_spread_q8(port, clk_pin, period_q8)
+                                 : 0u;
+
+    __set_PRIMASK(primask);
+
+    strobe_timing_t t = {
+        .period_q8 = period_q8,
+        .open      = ps_to_cycles(FT_T_VALID_PS),
+        .setup     = ps_to_cycles(FT_T_SETUP_PS),
+        .skew      = g_fifo_calib.roundtrip + ((res->spread_q8 + 255u) >> 8),
+        .clks      = BRIDGE_STROBE_CLKS,
+    };
+
+    /* Too little slack to sample within one period: pulse instead */
+    if (!strobe_timing_fits(&t) && t.clks == 1u)
+    {
+        t.clks = 2u;
+    }
+    res->skew    = t.skew;
+    res->applied = strobe_timing_fits(&t);
+    if (res->applied)
+    {
+        *timing = t;
+        return;
+    }
+
+    /* Nothing derived fits and the defaults are known to be optimistic:
+     * keep them, but pulse so that a missed deadline loses no byte */
+    res->fallback     = true;
+    timing->period_q8 = period_q8;
+    if (timing->clks < CALIB_FALLBACK_CLKS)
+    {
+        timing->clks = CALIB_FALLBACK_CLKS;
+    }
+}
+
+#if BRIDGE_CALIB_PRBS && !BRIDGE_READER_DMA
+static uint8_t s_prbs_buf[CALIB_PRBS_BYTES];
+
+/**
+ * @brief Read CALIB_PRBS_BYTES from FIFO#1 with the current timing.
+ *
+ * @return false if the PC stopped sending before the buffer was full.
+ */
+static bool prbs_capture(uint32_t timeout)
+{
+    uint32_t got      = 0u;
+    uint32_t deadline = dwt_cycles() + timeout;
+
+    while (got < CALIB_PRBS_BYTES)
+    {
+        if (dwt_past(deadline))
+        {
+            return false;
+        }
+        if (!FIFO1_RXF_ACTIVE())
+        {
+            continue;
+        }
+        uint32_t len = CALIB_PRBS_BYTES - got;
+        if (len > BRIDGE_BURST_LEN)
+        {
+            len = BRIDGE_BURST_LEN;
+        }
+        got += fifo1_strobe_read(&s_prbs_buf[got], len);
+    }
+    return true;
+}
+
+/**
+ * @brief Step the read leg's open down until PRBS errors appear, then back
+ *        off; drain what the PC sent afterwards.
+ */
+static void calibrate_prbs(void)
+{
+    uint32_t timeout = (SystemCoreClock / 1000u) * CALIB_PRBS_TIMEOUT_MS;
+    uint32_t derived = g_fifo1_timing.open;
+    uint32_t open    = derived;
+    bool     found   = false;
+
+    for (;;)
+    {
+        g_fifo1_timing.open = open;
+        if (!prbs_capture(timeout))
+        {
+            break;  /* no PRBS source */
+        }
+        g_fifo_calib.prbs_run = true;
+
+        prbs31_t chk;
+        uint32_t errors = prbs31_sync(&chk, s_prbs_buf)
+                        ? prbs31_check(&chk, &s_prbs_buf[4],
+                                       CALIB_PRBS_BYTES - 4u)
+                        : CALIB_PRBS_BYTES * 8u;
+        if (errors != 0u)
+        {
+            g_fifo_calib.prbs_errors = errors;
+            break;
+        }
+        found                  = true;
+        g_fifo_calib.prbs_open = open;
+        if (open == 0u)
+        {
+            break;
+        }
+        open--;
+    }
+
+    open = derived;
+    if (found && g_fifo_calib.prbs_open + CALIB_PRBS_BACKOFF < derived)
+    {
+        open = g_fifo_calib.prbs_open + CALIB_PRBS_BACKOFF;
+    }
+    g_fifo1_timing.open = open;
+
+    /* Discard the rest of the PRBS stream so it is not bridged */
+    uint32_t start = dwt_cycles();
+    uint32_t idle  = start;
+    while (!dwt_past(idle + SystemCoreClock / 1000u) &&
+           !dwt_past(start + timeout))
+    {
+        if (FIFO1_RXF_ACTIVE())
+        {
+            (void)fifo1_strobe_read(s_prbs_buf, BRIDGE_BURST_LEN);
+            idle = dwt_cycles();
+        }
+    }
+    FIFO1_OE_DEASSERT();
+}
+#endif /* BRIDGE_CALIB_PRBS && !BRIDGE_READER_DMA */
+
+/* ======================================================================== */
+void fifo_calibrate(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    g_fifo_calib.roundtrip = measure_roundtrip();
+    __set_PRIMASK(primask);
+
+#if !BRIDGE_READER_DMA
+    calibrate_leg(&g_fifo_calib.leg[0], &g_fifo1_timing,
+                  FIFO1_CTRL_PORT, FIFO1_CLKOUT_PIN);
+#if BRIDGE_CALIB_PRBS
+    calibrate_prbs();
+#endif
+#endif
+#if !BRIDGE_WRITER_DMA
+    calibrate_leg(&g_fifo_calib.leg[1], &g_fifo2_timing,
+                  FIFO2_CTRL_PORT, FIFO2_CLKOUT_PIN);
+#endif
+}
@@ -0,0 +1,127 @@
+/**
+ * @file fifo_crc.c
+ * @brief FIFB CRC32 checks on the CRC unit (see fifo_crc.h).
+ *
+ * CRC unit set-up for the reflected ISO 3309 CRC:
+ *   POL      0x04C11DB7 (reset value), 32-bit
+ *   REV_IN   bit-reversal by word for 32-bit writes: byte 0 of the word
+ *            ends up in bits 31:24, reflected, so it is processed first;
+ *            by byte for the 8-bit writes of unaligned heads and tails
+ *   REV_OUT  set, so DR reads back the reflected running CRC, which is
+ *            what fifb.h keeps (no final XOR is applied by the unit)
+ * The unit's internal register holds the CRC unreflected, so resuming a
+ * running CRC means loading INIT with its bit reverse.
+ */
+
+#include "fifo_crc.h"
+#include <string.h>
+
+#if BRIDGE_CRC
+
+fifo_crc_t g_fifo_crc BRIDGE_HOT_BSS;
+
+/* ---- Private helpers --------------------------------------------------- */
+
+#define CRC_CR_IN_BYTE  (CRC_CR_REV_IN_0 | CRC_CR_REV_OUT)
+#define CRC_CR_IN_WORD  (CRC_CR_REV_IN_0 | CRC_CR_REV_IN_1 | CRC_CR_REV_OUT)
+
+/**
+ * @brief Running CRC32 update on the CRC unit (fifb_crc_fn).
+ *
+ * Interrupts are masked while the unit holds this caller's CRC, so the
+ * other leg's task cannot slip in between INIT and the read-back.
+ */
+BRIDGE_HOT_CODE static uint32_t crc_hw_update(uint32_t crc, const uint8_t *p,
+                                              uint32_t len)
+{
+    volatile uint8_t *dr8 = (volatile uint8_t *)&CRC->DR;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    CRC->INIT = __RBIT(crc);
+    CRC->CR   = CRC_CR_IN_BYTE | CRC_CR_RESET;
+    while (len != 0u && ((uintptr_t)p & 3u) != 0u)
+    {
+        *dr8 = *p++;
+        len--;
+    }
+
+    CRC->CR = CRC_CR_IN_WORD;
+    for (; len >= 4u; len -= 4u, p += 4u)
+    {
+        uint32_t w;
+        memcpy(&w, p, 4u);
+        CRC->DR = w;
+    }
+
+    CRC->CR = CRC_CR_IN_BYTE;
+    while (len != 0u)
+    {
+        *dr8 = *p++;
+        len--;
+    }
+    crc = CRC->DR;
+
+    __set_PRIMASK(primask);
+    return crc;
+}
+
+/**
+ * @brief Count a finished transfer on the leg that owns @p t and log it.
+ *
+ * The FIFO#1 tracker always finishes a transfer before the FIFO#2 one (the
+ * bytes reach FIFO#2 later), so it opens the log entry and the FIFO#2
+ * verdict is filled in if the entry still belongs to that transfer.
+ */
+static void crc_done(fifb_tracker_t *t, fifb_result_t r)
+{
+    uint32_t         leg = (t == &g_fifo_crc.trk[0]) ? 0u : 1u;
+    fifo_crc_leg_t  *c   = &g_fifo_crc.leg[leg];
+    fifo_crc_xfer_t *x   = &g_fifo_crc.log[t->seq & (FIFO_CRC_LOG - 1u)];
+
+    switch (r)
+    {
+    case FIFB_OK:          c->ok++;          break;
+    case FIFB_BAD_HEADER:  c->bad_header++;  break;
+    default:               c->bad_payload++; break;
+    }
+
+    if (leg == 0u)
+    {
+        x->seq  = t->seq;
+        x->size = (r == FIFB_BAD_HEADER) ? 0u : t->size;
+        x->rx   = (uint8_t)r;
+        x->tx   = FIFO_CRC_PENDING;
+    }
+    else if (x->seq == t->seq)
+    {
+        x->tx = (uint8_t)r;
+    }
+}
+
+/* ======================================================================== */
+void fifo_crc_init(void)
+{
+    __HAL_RCC_CRC_CLK_ENABLE();
+    CRC->POL = 0x04C11DB7u;
+    CRC->CR  = CRC_CR_IN_BYTE | CRC_CR_RESET;
+
+    memset(&g_fifo_crc, 0, sizeof(g_fifo_crc));
+    fifb_init(&g_fifo_crc.trk[0], crc_hw_update, crc_done);
+    fifb_init(&g_fifo_crc.trk[1], crc_hw_update, crc_done);
+}
+
+/* ======================================================================== */
+BRIDGE_HOT_CODE void fifo_crc_rx(const uint8_t *p, uint32_t len)
+{
+    fifb_feed(&g_fifo_crc.trk[0], p, len);
+}
+
+/* ======================================================================== */
+BRIDGE_HOT_CODE void fifo_crc_tx(const uint8_t *p, uint32_t len)
+{
+    fifb_feed(&g_fifo_crc.trk[1], p, len);
+}
+
+#endif /* BRIDGE_CRC */
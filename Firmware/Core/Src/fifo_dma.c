@@ -0,0 +1,520 @@
+/**
+ * @file fifo_dma.c
+ * @brief Timer-paced DMA engine for the FT2232HL 245-Sync-FIFO bridge on
+ *        STM32H750 DevEBox.  See fifo_dma.h for the strobe timing.
+ *
+ * -------------------------------------------------------------------------
+ * FIFO#1 read leg (BRIDGE_READER_DMA=1):
+ *
+ *   ReaderTask hands fifo1_dma_read() the contiguous region returned by
+ *   rb_reserve().  The region and a status array are armed as the targets
+ *   of DMA1 Stream2 / Stream0; Stream1 / Stream3 write RD# low / high into
+ *   GPIOC->BSRR.  All four streams get the same NDTR, so after N periods
+ *   every one of them is exhausted at once and Stream3's transfer-complete
+ *   interrupt wakes the task.  RXF# going idle wakes it too (EXTI0, via
+ *   fifo1_dma_rxf_edge() from the handler in fifo_exti.c).
+ *
+ *   Stopping always happens on a period boundary (one-pulse mode), so the
+ *   four NDTRs agree once the last requested transfer has landed; a strobe
+ *   is never issued without its sample.
+ *
+ * FIFO#2 write leg (BRIDGE_WRITER_DMA=1):
+ *
+ *   WriterTask hands fifo2_dma_write() the region returned by rb_peek().
+ *   Each byte is expanded into the GPIOF->BSRR word FIFO2_WRITE_DATA() would
+ *   store (one g_fifo2_bsrr_lut[] load), in a staging array that DMA1
+ *   Stream4 feeds to the port; Stream5 samples TXE#, Stream6 / Stream7
+ *   drive WR# low / high via GPIOD->BSRR.
+ *
+ *   TXE# going high (FIFO#2 full) closes the CLKOUT trigger through EXTI1,
+ *   the running period completes and the chunk ends there.  Each TXE#
+ *   sample is taken after WR# falls, in the CLKOUT period of the accepting
+ *   edge, so it is the level the FT2232H decides on.  Strobes whose sample
+ *   was high were ignored; only the prefix before the first of them counts
+ *   as sent.  The rest is not released from the ring buffer, so it is
+ *   carried into the next staging pass and stream order is preserved.
+ *   This relies on TXE# staying high for longer than the EXTI1 latency plus
+ *   a period, which holds because the FT2232H frees space a USB packet at a
+ *   time.
+ *
+ * -------------------------------------------------------------------------
+ * Cache note (STM32H7):
+ *   DMA1 writes the ring buffer and status arrays behind the D-cache.  After
+ *   a chunk they are invalidated before the CPU reads them.  Compaction is
+ *   the only CPU write into the ring region; when it moves bytes the range
+ *   is cleaned right away, so a later invalidate (which works on whole
+ *   32-byte lines shared with the next chunk) never discards CPU data and a
+ *   dirty line is never evicted over DMA data.  The staging array is
+ *   cleaned before DMA1 reads it.  The ring storage, staging/status arrays
+ *   and strobe words must be in AXI-SRAM (.bss), not DTCM, which DMA1
+ *   cannot reach.
+ * -------------------------------------------------------------------------
+ */
+
+#include "fifo_dma.h"
+#include "fifo_exti.h"
+#include "cmsis_os.h"
+
+#if BRIDGE_READER_DMA || BRIDGE_WRITER_DMA
+
+/* ---- Register helpers -------------------------------------------------- */
+
+/** Peripheral → memory, 8-bit, memory increment, high priority */
+#define DMA_CR_SAMPLE   (DMA_SxCR_MINC | DMA_SxCR_PL_1)
+
+/** Memory → peripheral, 32-bit, fixed addresses, very high priority */
+#define DMA_CR_STROBE   (DMA_SxCR_DIR_0 | DMA_SxCR_PSIZE_1 | \
+                         DMA_SxCR_MSIZE_1 | DMA_SxCR_PL_1 | DMA_SxCR_PL_0)
+
+/** Memory → peripheral, 32-bit, memory increment, very high priority */
+#define DMA_CR_STREAM   (DMA_CR_STROBE | DMA_SxCR_MINC)
+
+/** Every interrupt flag of streams 0..3 (LIFCR) or 4..7 (HIFCR) */
+#define DMA_IFCR_ALL_STREAMS   0x0F7D0F7Du
+
+/** Slave mode off; trigger input ETRF (CLKOUT, no filter or prescaler) */
+#define SMCR_CLKOUT_OFF        (TIM_SMCR_TS_2 | TIM_SMCR_TS_1 | TIM_SMCR_TS_0)
+
+/** Trigger mode: each rising CLKOUT edge starts a one-pulse period */
+#define SMCR_CLKOUT_TRIGGER    (SMCR_CLKOUT_OFF | TIM_SMCR_SMS_2 | \
+                                TIM_SMCR_SMS_1)
+
+/* ---- Shared helpers ---------------------------------------------------- */
+
+static void stream_setup(DMA_Stream_TypeDef *s, uint32_t cr,
+                         volatile void *par, const void *mar, uint32_t n)
+{
+    s->CR = 0u;
+    while ((s->CR & DMA_SxCR_EN) != 0u) {}
+    s->PAR  = (uint32_t)(uintptr_t)par;
+    s->M0AR = (uint32_t)(uintptr_t)mar;
+    s->NDTR = n;
+    s->FCR  = 0u;  /* direct mode */
+    s->CR   = cr;
+}
+
+static void stream_stop(DMA_Stream_TypeDef *s)
+{
+    s->CR &= ~DMA_SxCR_EN;
+    while ((s->CR & DMA_SxCR_EN) != 0u) {}
+}
+
+#endif /* BRIDGE_READER_DMA || BRIDGE_WRITER_DMA */
+
+#if BRIDGE_READER_DMA
+
+/* ======================================================================== */
+/* FIFO#1 read leg                                                          */
+/* ======================================================================== */
+
+#define FIFO1_DMA_STATUS  DMA1_Stream0   /* CC1: GPIOC->IDR → s_fifo1_status[] */
+#define FIFO1_DMA_RD_LOW  DMA1_Stream1   /* CC2: RD# low  → GPIOC->BSRR        */
+#define FIFO1_DMA_DATA    DMA1_Stream2   /* CC3: GPIOE->IDR → ring buffer      */
+#define FIFO1_DMA_RD_HIGH DMA1_Stream3   /* CC4: RD# high → GPIOC->BSRR        */
+
+/** GPIOC->IDR sampled at CC1 of each period; RXF# low = strobe was valid */
+static uint8_t  s_fifo1_status[FIFO1_DMA_CHUNK] __attribute__((aligned(32)));
+
+/** BSRR words for RD# low / high, read by the strobe streams */
+static uint32_t s_rd_words[8] __attribute__((aligned(32)));
+
+/** True while a chunk is armed; the ISRs leave TIM2 alone otherwise */
+static volatile bool s_fifo1_armed;
+
+/**
+ * @brief Arm all four streams for @p n strobes into @p dst and let RXF#
+ *        open the CLKOUT trigger.
+ */
+static void fifo1_dma_arm(uint8_t *dst, uint32_t n)
+{
+    DMA1->LIFCR = DMA_IFCR_ALL_STREAMS;
+
+    stream_setup(FIFO1_DMA_STATUS,  DMA_CR_SAMPLE, &FIFO1_CTRL_PORT->IDR,
+                 s_fifo1_status, n);
+    stream_setup(FIFO1_DMA_RD_LOW,  DMA_CR_STROBE, &FIFO1_CTRL_PORT->BSRR,
+                 &s_rd_words[0], n);
+    stream_setup(FIFO1_DMA_DATA,    DMA_CR_SAMPLE, &FIFO1_DATA_PORT->IDR,
+                 dst, n);
+    stream_setup(FIFO1_DMA_RD_HIGH, DMA_CR_STROBE | DMA_SxCR_TCIE,
+                 &FIFO1_CTRL_PORT->BSRR, &s_rd_words[1], n);
+
+    TIM2->SMCR = SMCR_CLKOUT_OFF;
+    TIM2->CR1  = TIM_CR1_OPM;
+    TIM2->CNT  = 0u;
+    TIM2->SR   = 0u;
+
+    FIFO1_DMA_STATUS->CR  |= DMA_SxCR_EN;
+    FIFO1_DMA_RD_LOW->CR  |= DMA_SxCR_EN;
+    FIFO1_DMA_DATA->CR    |= DMA_SxCR_EN;
+    FIFO1_DMA_RD_HIGH->CR |= DMA_SxCR_EN;
+
+    FIFO1_OE_ASSERT();
+
+    /* From here on EXTI0 gates the trigger; open it if data is already
+     * there */
+    s_fifo1_armed = true;
+    fifo_exti_unmask(FIFO_EXTI_RXF);
+    if (FIFO1_RXF_ACTIVE())
+    {
+        TIM2->SMCR = SMCR_CLKOUT_TRIGGER;
+    }
+}
+
+/**
+ * @brief Stop on a period boundary and return the number of strobes run.
+ */
+static uint32_t fifo1_dma_disarm(uint32_t n)
+{
+    s_fifo1_armed = false;
+    fifo_exti_mask(FIFO_EXTI_RXF);
+
+    /* No new periods; the running one finishes and stops */
+    TIM2->SMCR = SMCR_CLKOUT_OFF;
+    while ((TIM2->CR1 & TIM_CR1_CEN) != 0u) {}
+
+    /* The last period's requests may still be in flight; wait until every
+     * stream has caught up with the RD# high stream */
+    while (FIFO1_DMA_STATUS->NDTR != FIFO1_DMA_RD_HIGH->NDTR ||
+           FIFO1_DMA_DATA->NDTR   != FIFO1_DMA_RD_HIGH->NDTR) {}
+
+    uint32_t done = n - FIFO1_DMA_DATA->NDTR;
+
+    stream_stop(FIFO1_DMA_STATUS);
+    stream_stop(FIFO1_DMA_RD_LOW);
+    stream_stop(FIFO1_DMA_DATA);
+    stream_stop(FIFO1_DMA_RD_HIGH);
+
+    FIFO1_RD_DEASSERT();
+    FIFO1_OE_DEASSERT();
+    return done;
+}
+
+void fifo1_dma_init(void)
+{
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    __HAL_RCC_TIM2_CLK_ENABLE();
+
+    s_rd_words[0] = (uint32_t)FIFO1_RD_PIN << 16;  /* RD# low  */
+    s_rd_words[1] = (uint32_t)FIFO1_RD_PIN;        /* RD# high */
+    SCB_CleanDCache_by_Addr(s_rd_words, sizeof(s_rd_words));
+
+    /* TIM2 compare events → DMA1 streams 0..3 */
+    DMAMUX1_Channel0->CCR = DMA_REQUEST_TIM2_CH1;
+    DMAMUX1_Channel1->CCR = DMA_REQUEST_TIM2_CH2;
+    DMAMUX1_Channel2->CCR = DMA_REQUEST_TIM2_CH3;
+    DMAMUX1_Channel3->CCR = DMA_REQUEST_TIM2_CH4;
+
+    /* TIM2: started by a rising CLKOUT edge on ETR (PA5), then counts one
+     * period at the timer clock and stops (one-pulse).  Compare channels
+     * frozen (no pins), one DMA request per channel per period.  Without
+     * its prescaler ETR takes up to a quarter of the timer clock, which
+     * 60 MHz just meets. */
+    TIM2->CR1   = TIM_CR1_OPM;
+    TIM2->SMCR  = SMCR_CLKOUT_OFF;
+    TIM2->PSC   = 0u;
+    TIM2->ARR   = FIFO1_DMA_PERIOD - 1u;
+    TIM2->CCMR1 = 0u;
+    TIM2->CCMR2 = 0u;
+    TIM2->CCR1  = FIFO1_DMA_STATUS_AT;
+    TIM2->CCR2  = FIFO1_DMA_RD_LOW_AT;
+    TIM2->CCR3  = FIFO1_DMA_SAMPLE_AT;
+    TIM2->CCR4  = FIFO1_DMA_RD_HIGH_AT;
+    TIM2->DIER  = TIM_DIER_CC1DE | TIM_DIER_CC2DE |
+                  TIM_DIER_CC3DE | TIM_DIER_CC4DE;
+    TIM2->EGR   = TIM_EGR_UG;  /* load PSC/ARR */
+    TIM2->SR    = 0u;
+
+    HAL_NVIC_SetPriority(DMA1_Stream3_IRQn, FIFO_DMA_IRQ_PRIORITY, 0u);
+    HAL_NVIC_EnableIRQ(DMA1_Stream3_IRQn);
+}
+
+uint32_t fifo1_dma_read(uint8_t *dst, uint32_t len)
+{
+    if (len > FIFO1_DMA_CHUNK)
+    {
+        len = FIFO1_DMA_CHUNK;
+    }
+    if (len == 0u)
+    {
+        return 0u;
+    }
+
+    /* Drop a wake-up left over from the previous chunk */
+    (void)osThreadFlagsWait(BRIDGE_FLAG_DMA, osFlagsWaitAny, 0u);
+
+    fifo1_dma_arm(dst, len);
+    (void)osThreadFlagsWait(BRIDGE_FLAG_DMA, osFlagsWaitAny, osWaitForever);
+    uint32_t done = fifo1_dma_disarm(len);
+
+    if (done == 0u)
+    {
+        return 0u;
+    }
+
+    /* DMA wrote behind the cache */
+    SCB_InvalidateDCache_by_Addr(s_fifo1_status, (int32_t)done);
+    SCB_InvalidateDCache_by_Addr(dst, (int32_t)done);
+
+    /* Drop strobes issued while RXF# was already high */
+    uint32_t n = 0u;
+    bool moved = false;
+    for (uint32_t i = 0u; i < done; i++)
+    {
+        if ((s_fifo1_status[i] & FIFO1_RXF_PIN) == 0u)
+        {
+            if (n != i)
+            {
+                dst[n] = dst[i];
+                moved  = true;
+            }
+            n++;
+        }
+    }
+    if (moved)
+    {
+        SCB_CleanDCache_by_Addr(dst, (int32_t)n);
+    }
+    return n;
+}
+
+/**
+ * @brief RXF# edge: let CLKOUT start strobe periods while FIFO#1 has data;
+ *        when it empties, stop at the end of the current period and wake
+ *        ReaderTask.
+ */
+void fifo1_dma_rxf_edge(void)
+{
+    if (!s_fifo1_armed)
+    {
+        return;
+    }
+    if (FIFO1_RXF_ACTIVE())
+    {
+        TIM2->SMCR = SMCR_CLKOUT_TRIGGER;
+    }
+    else
+    {
+        TIM2->SMCR = SMCR_CLKOUT_OFF;  /* the running period completes */
+        (void)osThreadFlagsSet(g_reader_thread, BRIDGE_FLAG_DMA);
+    }
+}
+
+/**
+ * @brief Last RD# high of the chunk done: stop the timer, wake ReaderTask.
+ */
+void DMA1_Stream3_IRQHandler(void)
+{
+    if ((DMA1->LISR & DMA_LISR_TCIF3) != 0u)
+    {
+        DMA1->LIFCR   = DMA_LIFCR_CTCIF3;
+        s_fifo1_armed = false;
+        TIM2->SMCR    = SMCR_CLKOUT_OFF;
+        TIM2->CR1     = TIM_CR1_OPM;  /* CC4 was the period's last event */
+        (void)osThreadFlagsSet(g_reader_thread, BRIDGE_FLAG_DMA);
+    }
+}
+
+#endif /* BRIDGE_READER_DMA */
+
+#if BRIDGE_WRITER_DMA
+
+/* ======================================================================== */
+/* FIFO#2 write leg                                                         */
+/* ======================================================================== */
+
+#define FIFO2_DMA_DATA    DMA1_Stream4   /* CC1: s_fifo2_stage[] → GPIOF->BSRR */
+#define FIFO2_DMA_STATUS  DMA1_Stream5   /* CC2: GPIOD->IDR → s_fifo2_status[] */
+#define FIFO2_DMA_WR_LOW  DMA1_Stream6   /* CC3: WR# low  → GPIOD->BSRR        */
+#define FIFO2_DMA_WR_HIGH DMA1_Stream7   /* CC4: WR# high → GPIOD->BSRR        */
+
+/** Precomputed GPIOF->BSRR word per byte of the current chunk */
+static uint32_t s_fifo2_stage[FIFO2_DMA_CHUNK] __attribute__((aligned(32)));
+
+/** GPIOD->IDR sampled at CC2 of each period; TXE# low = byte accepted */
+static uint8_t  s_fifo2_status[FIFO2_DMA_CHUNK] __attribute__((aligned(32)));
+
+/** BSRR words for WR# low / high, read by the strobe streams */
+static uint32_t s_wr_words[8] __attribute__((aligned(32)));
+
+/** True while a chunk is armed; the ISRs leave TIM8 alone otherwise */
+static volatile bool s_fifo2_armed;
+
+/** Set once TXE# has stopped the chunk; it is not restarted afterwards */
+static volatile bool s_fifo2_stopping;
+
+/**
+ * @brief Arm all four streams for @p n strobes and let TXE# open the
+ *        CLKOUT trigger.
+ */
+static void fifo2_dma_arm(uint32_t n)
+{
+    DMA1->HIFCR = DMA_IFCR_ALL_STREAMS;
+
+    stream_setup(FIFO2_DMA_DATA,    DMA_CR_STREAM, &FIFO2_DATA_PORT->BSRR,
+                 s_fifo2_stage, n);
+    stream_setup(FIFO2_DMA_STATUS,  DMA_CR_SAMPLE, &FIFO2_CTRL_PORT->IDR,
+                 s_fifo2_status, n);
+    stream_setup(FIFO2_DMA_WR_LOW,  DMA_CR_STROBE, &FIFO2_CTRL_PORT->BSRR,
+                 &s_wr_words[0], n);
+    stream_setup(FIFO2_DMA_WR_HIGH, DMA_CR_STROBE | DMA_SxCR_TCIE,
+                 &FIFO2_CTRL_PORT->BSRR, &s_wr_words[1], n);
+
+    TIM8->SMCR = SMCR_CLKOUT_OFF;
+    TIM8->CR1  = TIM_CR1_OPM;
+    TIM8->CNT  = 0u;
+    TIM8->SR   = 0u;
+
+    FIFO2_DMA_DATA->CR    |= DMA_SxCR_EN;
+    FIFO2_DMA_STATUS->CR  |= DMA_SxCR_EN;
+    FIFO2_DMA_WR_LOW->CR  |= DMA_SxCR_EN;
+    FIFO2_DMA_WR_HIGH->CR |= DMA_SxCR_EN;
+
+    /* Let the EXTI1 handler decide whether to start: pend it in software so
+     * the TXE# level is only ever evaluated in one place */
+    s_fifo2_stopping = false;
+    s_fifo2_armed    = true;
+    fifo_exti_unmask(FIFO_EXTI_TXE);
+    EXTI->SWIER1 = FIFO_EXTI_TXE;
+}
+
+/**
+ * @brief Stop on a period boundary and return the number of strobes run.
+ */
+static uint32_t fifo2_dma_disarm(uint32_t n)
+{
+    s_fifo2_armed = false;
+    fifo_exti_mask(FIFO_EXTI_TXE);
+
+    TIM8->SMCR = SMCR_CLKOUT_OFF;
+    while ((TIM8->CR1 & TIM_CR1_CEN) != 0u) {}
+
+    while (FIFO2_DMA_DATA->NDTR   != FIFO2_DMA_WR_HIGH->NDTR ||
+           FIFO2_DMA_STATUS->NDTR != FIFO2_DMA_WR_HIGH->NDTR ||
+           FIFO2_DMA_WR_LOW->NDTR != FIFO2_DMA_WR_HIGH->NDTR) {}
+
+    uint32_t done = n - FIFO2_DMA_WR_HIGH->NDTR;
+
+    stream_stop(FIFO2_DMA_DATA);
+    stream_stop(FIFO2_DMA_STATUS);
+    stream_stop(FIFO2_DMA_WR_LOW);
+    stream_stop(FIFO2_DMA_WR_HIGH);
+
+    FIFO2_WR_DEASSERT();
+    return done;
+}
+
+void fifo2_dma_init(void)
+{
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    __HAL_RCC_TIM8_CLK_ENABLE();
+
+    s_wr_words[0] = (uint32_t)FIFO2_WR_PIN << 16;  /* WR# low  */
+    s_wr_words[1] = (uint32_t)FIFO2_WR_PIN;        /* WR# high */
+    SCB_CleanDCache_by_Addr(s_wr_words, sizeof(s_wr_words));
+
+    /* TIM8 compare events → DMA1 streams 4..7 */
+    DMAMUX1_Channel4->CCR = DMA_REQUEST_TIM8_CH1;
+    DMAMUX1_Channel5->CCR = DMA_REQUEST_TIM8_CH2;
+    DMAMUX1_Channel6->CCR = DMA_REQUEST_TIM8_CH3;
+    DMAMUX1_Channel7->CCR = DMA_REQUEST_TIM8_CH4;
+
+    /* TIM8: as TIM2, started by CLKOUT on ETR (PA0).  No outputs are
+     * used, so the break/dead-time unit stays off. */
+    TIM8->CR1   = TIM_CR1_OPM;
+    TIM8->SMCR  = SMCR_CLKOUT_OFF;
+    TIM8->PSC   = 0u;
+    TIM8->ARR   = FIFO2_DMA_PERIOD - 1u;
+    TIM8->RCR   = 0u;
+    TIM8->CCMR1 = 0u;
+    TIM8->CCMR2 = 0u;
+    TIM8->CCR1  = FIFO2_DMA_DATA_AT;
+    TIM8->CCR2  = FIFO2_DMA_STATUS_AT;
+    TIM8->CCR3  = FIFO2_DMA_WR_LOW_AT;
+    TIM8->CCR4  = FIFO2_DMA_WR_HIGH_AT;
+    TIM8->DIER  = TIM_DIER_CC1DE | TIM_DIER_CC2DE |
+                  TIM_DIER_CC3DE | TIM_DIER_CC4DE;
+    TIM8->EGR   = TIM_EGR_UG;
+    TIM8->SR    = 0u;
+
+    HAL_NVIC_SetPriority(DMA1_Stream7_IRQn, FIFO_DMA_IRQ_PRIORITY, 0u);
+    HAL_NVIC_EnableIRQ(DMA1_Stream7_IRQn);
+}
+
+uint32_t fifo2_dma_write(const uint8_t *src, uint32_t len)
+{
+    if (len > FIFO2_DMA_CHUNK)
+    {
+        len = FIFO2_DMA_CHUNK;
+    }
+    if (len == 0u)
+    {
+        return 0u;
+    }
+
+    /* Expand to BSRR words and push them out of the cache for DMA1 */
+    for (uint32_t i = 0u; i < len; i++)
+    {
+        s_fifo2_stage[i] = FIFO2_BSRR(src[i]);
+    }
+    SCB_CleanDCache_by_Addr(s_fifo2_stage, (int32_t)(len * sizeof(uint32_t)));
+
+    (void)osThreadFlagsWait(BRIDGE_FLAG_DMA, osFlagsWaitAny, 0u);
+
+    fifo2_dma_arm(len);
+    (void)osThreadFlagsWait(BRIDGE_FLAG_DMA, osFlagsWaitAny, osWaitForever);
+    uint32_t done = fifo2_dma_disarm(len);
+
+    if (done == 0u)
+    {
+        return 0u;
+    }
+    SCB_InvalidateDCache_by_Addr(s_fifo2_status, (int32_t)done);
+
+    /* Sent = prefix up to the first strobe the FT2232H ignored */
+    uint32_t n = 0u;
+    while (n < done && (s_fifo2_status[n] & FIFO2_TXE_PIN) == 0u)
+    {
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief TXE# edge (or software pend from fifo2_dma_arm()): let CLKOUT start
+ *        strobe periods while FIFO#2 has room; once it fills, stop at the
+ *        end of the current period and wake WriterTask.
+ */
+void fifo2_dma_txe_edge(void)
+{
+    if (!s_fifo2_armed || s_fifo2_stopping)
+    {
+        return;
+    }
+    if (FIFO2_TXE_ACTIVE())
+    {
+        TIM8->SMCR = SMCR_CLKOUT_TRIGGER;
+    }
+    else if ((TIM8->SMCR & TIM_SMCR_SMS) != 0u)
+    {
+        s_fifo2_stopping = true;
+        TIM8->SMCR = SMCR_CLKOUT_OFF;  /* the running period completes */
+        (void)osThreadFlagsSet(g_writer_thread, BRIDGE_FLAG_DMA);
+    }
+}
+
+/**
+ * @brief Last WR# high of the chunk done: stop the timer, wake WriterTask.
+ */
+void DMA1_Stream7_IRQHandler(void)
+{
+    if ((DMA1->HISR & DMA_HISR_TCIF7) != 0u)
+    {
+        DMA1->HIFCR   = DMA_HIFCR_CTCIF7;
+        s_fifo2_armed = false;
+        TIM8->SMCR    = SMCR_CLKOUT_OFF;
+        TIM8->CR1     = TIM_CR1_OPM;  /* CC4 was the period's last event */
+        (void)osThreadFlagsSet(g_writer_thread, BRIDGE_FLAG_DMA);
+    }
+}
+
+#endif /* BRIDGE_WRITER_DMA */
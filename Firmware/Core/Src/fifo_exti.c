@@ -0,0 +1,136 @@
+/**
+ * @file fifo_exti.c
+ * @brief EXTI0 / EXTI1 setup and dispatch for the FT2232HL 245-Sync-FIFO
+ *        bridge (see fifo_exti.h).
+ *
+ * The handlers live here rather than in fifo_dma.c so that both users of a
+ * line share one vector: a DMA leg gets its gate callback, a CPU leg gets
+ * its task woken.
+ */
+
+#include "fifo_exti.h"
+#include "fifo_dma.h"
+#include "fifo_tele.h"
+#include "cmsis_os.h"
+
+/* ---- Private helpers --------------------------------------------------- */
+
+/**
+ * Longest fifo_exti_wait() sleep.  Edges are never missed (the line is
+ * unmasked before the pin is checked), so only BridgeTask, which also
+ * sends the telemetry frames, needs to wake up on its own.
+ */
+#if BRIDGE_SINGLE_TASK
+#define EXTI_WAIT_TIMEOUT     fifo_tele_idle_wait()
+#else
+#define EXTI_WAIT_TIMEOUT     osWaitForever
+#endif
+
+/** SYSCFG_EXTICRx port codes */
+#define SYSCFG_EXTI_PORTC     2u
+#define SYSCFG_EXTI_PORTD     3u
+
+/** Route EXTI line @p pin (single GPIO_PIN_x, x < 4) to @p port, both edges */
+static void exti_setup(uint32_t pin, uint32_t port, IRQn_Type irq)
+{
+    uint32_t shift = 4u * (uint32_t)__builtin_ctz(pin);
+
+    SYSCFG->EXTICR[0] = (SYSCFG->EXTICR[0] & ~(0xFu << shift)) | (port << shift);
+    EXTI->RTSR1   |= pin;
+    EXTI->FTSR1   |= pin;
+    EXTI_D1->IMR1 &= ~pin;
+
+    HAL_NVIC_SetPriority(irq, FIFO_EXTI_IRQ_PRIORITY, 0u);
+    HAL_NVIC_EnableIRQ(irq);
+}
+
+#if BRIDGE_EXTI_WAKE
+/**
+ * @brief Wake the task sleeping on @p line (from its handler).
+ */
+static void exti_wake(uint32_t line, osThreadId_t thread)
+{
+    EXTI_D1->IMR1 &= ~line;
+    (void)osThreadFlagsSet(thread, BRIDGE_FLAG_FIFO);
+}
+
+/**
+ * @brief True if a condition waited for by @p lines already holds.
+ */
+static bool exti_ready(uint32_t lines)
+{
+    return ((lines & FIFO_EXTI_RXF) != 0u && FIFO1_RXF_ACTIVE()) ||
+           ((lines & FIFO_EXTI_TXE) != 0u && FIFO2_TXE_ACTIVE());
+}
+#endif /* BRIDGE_EXTI_WAKE */
+
+/* ======================================================================== */
+void fifo_exti_init(void)
+{
+    __HAL_RCC_SYSCFG_CLK_ENABLE();
+
+    /* RXF# (PC0) on EXTI0, TXE# (PD1) on EXTI1 */
+    exti_setup(FIFO_EXTI_RXF, SYSCFG_EXTI_PORTC, EXTI0_IRQn);
+    exti_setup(FIFO_EXTI_TXE, SYSCFG_EXTI_PORTD, EXTI1_IRQn);
+}
+
+void fifo_exti_unmask(uint32_t lines)
+{
+    /* IMR1 is shared with the other leg's task and handler */
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    EXTI_D1->PR1   = lines;
+    EXTI_D1->IMR1 |= lines;
+    __set_PRIMASK(primask);
+}
+
+void fifo_exti_mask(uint32_t lines)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    EXTI_D1->IMR1 &= ~lines;
+    __set_PRIMASK(primask);
+}
+
+void fifo_exti_wait(uint32_t lines)
+{
+#if BRIDGE_EXTI_WAKE
+    fifo_exti_unmask(lines);
+    if (!exti_ready(lines))
+    {
+        (void)osThreadFlagsWait(BRIDGE_FLAG_FIFO, osFlagsWaitAny,
+                                EXTI_WAIT_TIMEOUT);
+    }
+    fifo_exti_mask(lines);
+#else
+    (void)lines;
+    (void)osThreadYield();
+#endif
+}
+
+/* ======================================================================== */
+/**
+ * @brief RXF# edge: gate the FIFO#1 DMA engine, or wake ReaderTask.
+ */
+void EXTI0_IRQHandler(void)
+{
+    EXTI_D1->PR1 = FIFO_EXTI_RXF;
+#if BRIDGE_READER_DMA
+    fifo1_dma_rxf_edge();
+#elif BRIDGE_EXTI_WAKE
+    exti_wake(FIFO_EXTI_RXF, g_reader_thread);
+#endif
+}
+
+/**
+ * @brief TXE# edge: gate the FIFO#2 DMA engine, or wake WriterTask.
+ */
+void EXTI1_IRQHandler(void)
+{
+    EXTI_D1->PR1 = FIFO_EXTI_TXE;
+#if BRIDGE_WRITER_DMA
+    fifo2_dma_txe_edge();
+#elif BRIDGE_EXTI_WAKE
+    exti_wake(FIFO_EXTI_TXE, g_writer_thread);
+#endif
+}
@@ -0,0 +1,190 @@
+/**
+ * @file fifo_prbs.c
+ * @brief PRBS-31 self-test tasks (see fifo_prbs.h).
+ *
+ * Each task owns its buffer and its half of g_fifo_prbs, so nothing is
+ * shared between them.  The buffers are plain .bss (AXI-SRAM), which the
+ * DMA engines can reach, aligned to a cache line.
+ *
+ * The generator refills its buffer only once FIFO#2 has taken all of it,
+ * three bytes per LFSR step (prbs31_fill()), so a refill costs about one
+ * cycle per byte against eight per CLKOUT strobe.
+ */
+
+#include "fifo_prbs.h"
+#include "fifo_strobe.h"
+#include "fifo_dma.h"
+#include "fifo_exti.h"
+#include "prbs.h"
+#include "dwt.h"
+#include "cmsis_os.h"
+
+#if BRIDGE_PRBS_TEST
+
+fifo_prbs_t g_fifo_prbs BRIDGE_HOT_BSS;
+
+/* ---- Private state ----------------------------------------------------- */
+
+#if BRIDGE_READER_DMA
+#define PRBS_RX_LEN  FIFO1_DMA_CHUNK
+#else
+#define PRBS_RX_LEN  BRIDGE_BURST_LEN
+#endif
+
+#if BRIDGE_WRITER_DMA
+#define PRBS_TX_LEN  FIFO2_DMA_CHUNK
+#else
+#define PRBS_TX_LEN  BRIDGE_BURST_LEN
+#endif
+
+static uint8_t  s_rx_buf[PRBS_RX_LEN] __attribute__((aligned(32)));
+static uint8_t  s_tx_buf[PRBS_TX_LEN] __attribute__((aligned(32)));
+
+static prbs31_t s_chk;
+static uint32_t s_sync;     /* last bytes seen while unlocked, newest low */
+static uint32_t s_sync_n;   /* how many of them */
+
+/* ---- Private helpers --------------------------------------------------- */
+
+/**
+ * @brief Account a burst of @p n bytes that just ended on leg @p r.
+ *
+ * The time since the previous burst counts towards the rate unless it is
+ * longer than FIFO_PRBS_GAP_MS, in which case a new stretch starts here.
+ */
+BRIDGE_HOT_CODE static void prbs_rate(fifo_prbs_rate_t *r, uint32_t n)
+{
+    uint32_t now = dwt_cycles();
+    uint32_t gap = now - r->last;
+
+    if (n == 0u)
+    {
+        return;
+    }
+    if (r->bytes != 0u && gap < (SystemCoreClock / 1000u) * FIFO_PRBS_GAP_MS)
+    {
+        r->stream_bytes  += n;
+        r->stream_cycles += gap;
+    }
+    r->bytes += n;
+    r->last   = now;
+}
+
+/**
+ * @brief (Re)lock the checker on the last four bytes before @p end.
+ */
+static void prbs_lock(const uint8_t *end)
+{
+    g_fifo_prbs.locked = prbs31_sync(&s_chk, end - 4);
+    s_sync_n           = 0u;
+}
+
+/**
+ * @brief Check @p n bytes received from FIFO#1.
+ */
+BRIDGE_HOT_CODE static void prbs_check(const uint8_t *p, uint32_t n)
+{
+    /* Unlocked: collect four bytes (possibly over several bursts) */
+    while (!g_fifo_prbs.locked && n != 0u)
+    {
+        s_sync = (s_sync << 8) | *p++;
+        n--;
+        if (++s_sync_n >= 4u)
+        {
+            const uint8_t b[4] = {
+                (uint8_t)(s_sync >> 24), (uint8_t)(s_sync >> 16),
+                (uint8_t)(s_sync >> 8),  (uint8_t)s_sync,
+            };
+            prbs_lock(&b[4]);
+        }
+    }
+    if (n == 0u)
+    {
+        return;
+    }
+
+    uint32_t errors = prbs31_check(&s_chk, p, n);
+    if (errors > (n * 8u) / FIFO_PRBS_LOSS)
+    {
+        g_fifo_prbs.resyncs++;
+        if (n >= 4u)
+        {
+            prbs_lock(&p[n]);
+        }
+        else
+        {
+            g_fifo_prbs.locked = false;
+        }
+        return;
+    }
+    g_fifo_prbs.checked += n;
+    g_fifo_prbs.errors  += errors;
+}
+
+/* ======================================================================== */
+BRIDGE_HOT_CODE void StartPrbsCheckTask(void *argument)
+{
+    (void)argument;
+
+    for (;;)
+    {
+#if BRIDGE_READER_DMA
+        /* Sleeps until the chunk is complete or FIFO#1 runs dry */
+        uint32_t n = fifo1_dma_read(s_rx_buf, PRBS_RX_LEN);
+#else
+        if (!FIFO1_RXF_ACTIVE())
+        {
+            FIFO1_OE_DEASSERT();
+            fifo_exti_wait(FIFO_EXTI_RXF);
+            continue;
+        }
+        uint32_t n = fifo1_strobe_read(s_rx_buf, PRBS_RX_LEN);
+#endif
+        prbs_rate(&g_fifo_prbs.rx, n);
+        prbs_check(s_rx_buf, n);
+
+#if !BRIDGE_READER_DMA
+        osThreadYield();
+#endif
+    }
+}
+
+/* ======================================================================== */
+BRIDGE_HOT_CODE void StartPrbsGenTask(void *argument)
+{
+    (void)argument;
+
+    prbs31_t gen;
+    uint32_t pos = PRBS_TX_LEN;
+
+    prbs31_init(&gen, dwt_cycles());
+
+    for (;;)
+    {
+        if (pos == PRBS_TX_LEN)
+        {
+            prbs31_fill(&gen, s_tx_buf, PRBS_TX_LEN);
+            pos = 0u;
+        }
+
+#if BRIDGE_WRITER_DMA
+        /* Sleeps until the chunk is strobed or TXE# stops it */
+        uint32_t n = fifo2_dma_write(&s_tx_buf[pos], PRBS_TX_LEN - pos);
+#else
+        if (!FIFO2_TXE_ACTIVE())
+        {
+            fifo_exti_wait(FIFO_EXTI_TXE);
+            continue;
+        }
+        uint32_t n = fifo2_strobe_write(&s_tx_buf[pos], PRBS_TX_LEN - pos);
+#endif
+        pos += n;
+        prbs_rate(&g_fifo_prbs.tx, n);
+
+#if !BRIDGE_WRITER_DMA
+        osThreadYield();
+#endif
+    }
+}
+
+#endif /* BRIDGE_PRBS_TEST */
@@ -0,0 +1,132 @@
+/**
+ * @file fifo_reverse.c
+ * @brief Reverse channel (BRIDGE_REVERSE=1): RevReaderTask moves bytes
+ *        FIFO#2 → g_rev_buf, RevWriterTask moves them g_rev_buf → FIFO#1.
+ *
+ * The channel lets the Receiver PC talk back to the Sender PC
+ * (acknowledgements, NAKs, flow-control credits).  The firmware does not
+ * look at the bytes; it only preserves their order.
+ *
+ * -------------------------------------------------------------------------
+ * Sharing the FT2232H buses with the forward tasks:
+ *   FIFO#1 and FIFO#2 each have one 8-bit data bus.  Every CPU burst, in
+ *   either direction, acquires the bus it needs with interrupts masked
+ *   (strobe_bus_read() / strobe_bus_write() in fifo_strobe.h): a read sets
+ *   D[7:0] to input and asserts OE#, a write deasserts OE# and sets D[7:0]
+ *   to output.  Bursts cannot interleave, so no lock is needed, and a bus
+ *   is only turned around when the direction actually changes.
+ *
+ * Waiting:
+ *   RXF# of FIFO#2 (PD0) and TXE# of FIFO#1 (PC1) have no EXTI line of
+ *   their own (EXTI0 and EXTI1 belong to PC0 and PD1), so an idle reverse
+ *   task polls them every BRIDGE_REV_POLL ticks.  That is plenty for
+ *   control traffic.  RevWriterTask sleeps on BRIDGE_FLAG_DATA while
+ *   g_rev_buf is empty; RevReaderTask sets it after each burst.
+ * -------------------------------------------------------------------------
+ */
+
+#include "fifo_bridge.h"
+#include "fifo_strobe.h"
+#include "cmsis_os.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if BRIDGE_REVERSE
+
+/* ---- Private helpers --------------------------------------------------- */
+
+/** Set by RevWriterTask just before it blocks on BRIDGE_FLAG_DATA */
+static volatile bool s_rev_writer_waiting;
+
+/**
+ * @brief Block RevWriterTask until g_rev_buf holds data.
+ */
+static void rev_writer_wait_for_data(void)
+{
+    s_rev_writer_waiting = true;
+    __asm volatile("" ::: "memory");
+    if (rb_empty(&g_rev_buf))
+    {
+        (void)osThreadFlagsWait(BRIDGE_FLAG_DATA, osFlagsWaitAny,
+                                osWaitForever);
+    }
+    s_rev_writer_waiting = false;
+}
+
+/* ======================================================================== */
+/**
+ * @brief RevReaderTask – reads FIFO#2 into g_rev_buf.
+ */
+void StartRevReaderTask(void *argument)
+{
+    (void)argument;
+
+    for (;;)
+    {
+        uint8_t *dst;
+        uint32_t space = rb_reserve(&g_rev_buf, &dst);
+        if (!FIFO2_RXF_ACTIVE())
+        {
+            /* Nothing from the Receiver PC: let WriterTask have the bus */
+            FIFO2_OE_DEASSERT();
+            vTaskDelay(BRIDGE_REV_POLL);
+            continue;
+        }
+        if (space == 0u)
+        {
+            /* RevWriterTask is behind; the FT2232H holds the rest */
+            vTaskDelay(BRIDGE_REV_POLL);
+            continue;
+        }
+        if (space > BRIDGE_BURST_LEN)
+        {
+            space = BRIDGE_BURST_LEN;
+        }
+
+        uint32_t n = fifo2_strobe_read(dst, space);
+        rb_commit(&g_rev_buf, n);
+        if (n != 0u && s_rev_writer_waiting)
+        {
+            (void)osThreadFlagsSet(g_rev_writer_thread, BRIDGE_FLAG_DATA);
+        }
+
+        osThreadYield();
+    }
+}
+
+/* ======================================================================== */
+/**
+ * @brief RevWriterTask – writes g_rev_buf to FIFO#1.
+ */
+void StartRevWriterTask(void *argument)
+{
+    (void)argument;
+
+    for (;;)
+    {
+        const uint8_t *src;
+        uint32_t avail = rb_peek(&g_rev_buf, &src);
+        if (avail == 0u)
+        {
+            rev_writer_wait_for_data();
+            continue;
+        }
+        if (!FIFO1_TXE_ACTIVE())
+        {
+            /* Sender PC not reading, or its FT2232H buffer is full */
+            vTaskDelay(BRIDGE_REV_POLL);
+            continue;
+        }
+        if (avail > BRIDGE_BURST_LEN)
+        {
+            avail = BRIDGE_BURST_LEN;
+        }
+
+        uint32_t n = fifo1_strobe_write(src, avail);
+        rb_release(&g_rev_buf, n);
+
+        osThreadYield();
+    }
+}
+
+#endif /* BRIDGE_REVERSE */
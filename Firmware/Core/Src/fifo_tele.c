@@ -0,0 +1,182 @@
+/**
+ * @file fifo_tele.c
+ * @brief Telemetry frame assembly and injection (see fifo_tele.h).
+ *
+ * The counters in g_fifo_tele are each written by one task only (bytes_in,
+ * ring_full, peak by the read leg; the rest by the write leg), and the frame
+ * is assembled by the write leg, so no locking is needed.  The peak is reset
+ * per frame; a read burst that races the reset is at worst counted towards
+ * the next frame.
+ */
+
+#include "fifo_tele.h"
+#include "fifo_strobe.h"
+#include "fifo_dma.h"
+#include "fifo_crc.h"
+#include "fifo_calib.h"
+#include "fifb.h"
+#include "dwt.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if BRIDGE_TELEMETRY
+
+fifo_tele_t g_fifo_tele BRIDGE_HOT_BSS;
+
+/* Frame period in ticks (this projdefs.h has no pdMS_TO_TICKS) */
+#define TELE_PERIOD_TICKS \
+    ((TickType_t)((FIFO_TELE_PERIOD_MS * configTICK_RATE_HZ) / 1000u))
+
+/* ---- Private state ----------------------------------------------------- */
+
+static fifb_tracker_t    s_trk;      /* framing of the bytes sent to FIFO#2 */
+static fifo_tele_frame_t s_frame;
+static uint32_t          s_pos;      /* bytes of s_frame sent */
+static TickType_t        s_last_tick;
+static uint64_t          s_last_idle;
+
+/* Idle task time in DWT cycles, updated from the context switch */
+static uint64_t          s_idle_cycles;
+static uint32_t          s_idle_since;
+static bool              s_idle_running;
+
+/* ---- Private helpers --------------------------------------------------- */
+
+/**
+ * @brief Fill s_frame from the counters and start a new period.
+ */
+static void tele_build(TickType_t now)
+{
+    /* The context switch may update the 64-bit sum mid-read otherwise */
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint64_t idle = s_idle_cycles;
+    __set_PRIMASK(primask);
+
+    /* total is in whole ticks, idle is exact: clamp the difference */
+    uint64_t total  = (uint64_t)(TickType_t)(now - s_last_tick) *
+                      (SystemCoreClock / configTICK_RATE_HZ);
+    uint64_t idle_d = idle - s_last_idle;
+    uint64_t busy   = (idle_d < total) ? total - idle_d : 0u;
+    uint16_t flags  = 0u;
+
+#if BRIDGE_CRC
+    flags |= FIFT_FLAG_CRC;
+#endif
+    if (g_fifo_calib.leg[0].fallback || g_fifo_calib.leg[1].fallback)
+    {
+        flags |= FIFT_FLAG_CALIB;
+    }
+
+    s_frame = (fifo_tele_frame_t){
+        .magic      = FIFT_MAGIC,
+        .version    = FIFT_VERSION,
+        .length     = (uint16_t)(offsetof(fifo_tele_frame_t, crc) -
+                                 offsetof(fifo_tele_frame_t, seq)),
+        .seq        = g_fifo_tele.frames,
+        .uptime_ms  = (uint32_t)now * (1000u / configTICK_RATE_HZ),
+        .bytes_in   = g_fifo_tele.bytes_in,
+        .bytes_out  = g_fifo_tele.bytes_out,
+        .ring_full  = g_fifo_tele.ring_full,
+        .fifo2_full = g_fifo_tele.fifo2_full,
+        .late       = g_fifo1_strobe.late + g_fifo2_strobe.late,
+        .buf_peak   = g_fifo_tele.peak,
+        .buf_size   = BRIDGE_BUF_SIZE,
+        .cpu_load   = (uint16_t)(total != 0u ? busy * 1000u / total : 0u),
+        .flags      = flags,
+#if BRIDGE_CRC
+        .crc_bad_in  = g_fifo_crc.leg[0].bad_header +
+                       g_fifo_crc.leg[0].bad_payload,
+        .crc_bad_out = g_fifo_crc.leg[1].bad_header +
+                       g_fifo_crc.leg[1].bad_payload,
+#endif
+    };
+    s_frame.crc = fifb_crc32_sw(FIFB_CRC_INIT, (const uint8_t *)&s_frame,
+                                offsetof(fifo_tele_frame_t, crc)) ^
+                  FIFB_CRC_INIT;
+
+    g_fifo_tele.peak = 0u;
+    g_fifo_tele.frames++;
+    s_pos       = 0u;
+    s_last_tick = now;
+    s_last_idle = idle;
+}
+
+/* ======================================================================== */
+void fifo_tele_init(void)
+{
+    g_fifo_tele = (fifo_tele_t){0};
+    fifb_init(&s_trk, fifb_crc32_sw, NULL);
+    s_trk.hdr_only = true;
+    s_pos          = sizeof(s_frame);  /* nothing pending */
+}
+
+/* ======================================================================== */
+BRIDGE_HOT_CODE bool fifo_tele_send(void)
+{
+    const uint8_t *f = (const uint8_t *)&s_frame;
+
+    if (s_pos == sizeof(s_frame))
+    {
+        TickType_t now = xTaskGetTickCount();
+        if ((TickType_t)(now - s_last_tick) < TELE_PERIOD_TICKS ||
+            !fifb_idle(&s_trk))
+        {
+            return false;
+        }
+        tele_build(now);
+    }
+
+#if BRIDGE_WRITER_DMA
+    s_pos += fifo2_dma_write(&f[s_pos], sizeof(s_frame) - s_pos);
+#else
+    if (FIFO2_TXE_ACTIVE())
+    {
+        s_pos += fifo2_strobe_write(&f[s_pos], sizeof(s_frame) - s_pos);
+    }
+#endif
+    return s_pos != sizeof(s_frame);
+}
+
+/* ======================================================================== */
+uint32_t fifo_tele_idle_wait(void)
+{
+    /* A frame cut short by TXE# goes on at the TXE# edge, and one held
+     * back by an open transfer goes out after more stream bytes */
+    if (s_pos != sizeof(s_frame) || !fifb_idle(&s_trk))
+    {
+        return osWaitForever;
+    }
+
+    TickType_t elapsed = (TickType_t)(xTaskGetTickCount() - s_last_tick);
+    if (elapsed >= TELE_PERIOD_TICKS)
+    {
+        return 0u;
+    }
+    return (uint32_t)(TELE_PERIOD_TICKS - elapsed);
+}
+
+/* ======================================================================== */
+BRIDGE_HOT_CODE void fifo_tele_tx(const uint8_t *p, uint32_t n)
+{
+    g_fifo_tele.bytes_out += n;
+    fifb_feed(&s_trk, p, n);
+}
+
+/* ======================================================================== */
+BRIDGE_HOT_CODE void fifo_tele_idle_in(void)
+{
+    s_idle_since   = dwt_cycles();
+    s_idle_running = true;
+}
+
+BRIDGE_HOT_CODE void fifo_tele_idle_out(void)
+{
+    if (s_idle_running)
+    {
+        s_idle_cycles += dwt_cycles() - s_idle_since;
+        s_idle_running = false;
+    }
+}
+
+#endif /* BRIDGE_TELEMETRY */
@@ -20,18 +20,75 @@
  *   buffer lives in AXI-SRAM (D1 domain, starting at 0x24000000) which is
  *   covered by the default MPU region with Write-Back/Read-Allocate caching.
  *   Since only the CPU accesses the ring buffer (no DMA), cache coherency is
- *   maintained automatically by the hardware.  If you later add DMA, place the
- *   DMA buffers in a separate MPU region marked as Non-Cacheable.
+ *   maintained automatically by the hardware.  With BRIDGE_READER_DMA the
+ *   read leg writes the ring buffer by DMA, and with BRIDGE_WRITER_DMA the
+ *   write leg reads a staging array by DMA; fifo_dma.c does the required
+ *   cache maintenance itself.
  */
 
 #include "main.h"
 #include "cmsis_os.h"
 #include "fifo_bridge.h"
+#include "fifo_dma.h"
+#include "fifo_exti.h"
+#include "fifo_strobe.h"
+#include "fifo_calib.h"
+#include "fifo_crc.h"
+#include "fifo_tele.h"
+#include "fifo_prbs.h"
+#include "rtos_stats.h"
+#include "rtos_trace.h"
+#include "dwt.h"
+#include "tcm.h"
 
+#if BRIDGE_USE_BLOCKS
+/* ---- Block pipeline (ReaderTask fills, WriterTask drains) -------------- */
+blkq_t g_free_blocks BRIDGE_HOT_BSS;
+blkq_t g_full_blocks BRIDGE_HOT_BSS;
+
+/* Block pool, in .bss (AXI-SRAM, see cache note above) or DTCM */
+static block_t g_block_pool[BRIDGE_BLOCK_COUNT] BRIDGE_BUF_BSS;
+#else
 /* ---- Shared ring buffer (producer: ReaderTask, consumer: WriterTask) --- */
-ring_buffer_t g_bridge_buf;
+ring_buffer_t g_bridge_buf BRIDGE_HOT_BSS;
+
+/* Backing storage, in .bss (AXI-SRAM, see cache note above) or DTCM */
+static uint8_t g_bridge_storage[BRIDGE_BUF_SIZE]
+    __attribute__((aligned(32))) BRIDGE_BUF_BSS;
+#endif
+
+#if BRIDGE_REVERSE
+/* ---- Reverse ring buffer (RevReaderTask → RevWriterTask) --------------- */
+ring_buffer_t g_rev_buf;
+static uint8_t g_rev_storage[BRIDGE_REV_BUF_SIZE] __attribute__((aligned(32)));
+#endif
+
+/* ---- Strobe timing + statistics (see fifo_strobe.h / fifo_calib.h) ----- */
+strobe_timing_t g_fifo1_timing BRIDGE_HOT_DATA = STROBE_TIMING_DEFAULT;
+strobe_timing_t g_fifo2_timing BRIDGE_HOT_DATA = STROBE_TIMING_DEFAULT;
+strobe_stats_t  g_fifo1_strobe BRIDGE_HOT_BSS;
+strobe_stats_t  g_fifo2_strobe BRIDGE_HOT_BSS;
+#if BRIDGE_REVERSE
+strobe_stats_t  g_fifo2_rev_strobe;
+strobe_stats_t  g_fifo1_rev_strobe;
+#endif
+
+/* ---- Task handles (used for watermark notifications) ------------------- */
+osThreadId_t g_reader_thread;
+osThreadId_t g_writer_thread;
+#if BRIDGE_REVERSE
+osThreadId_t g_rev_reader_thread;
+osThreadId_t g_rev_writer_thread;
+#endif
 
 /* ---- FreeRTOS thread attributes ---------------------------------------- */
+#if BRIDGE_SINGLE_TASK
+const osThreadAttr_t bridgeTask_attributes = {
+    .name       = "BridgeTask",
+    .stack_size = 512 * 4,
+    .priority   = (osPriority_t) osPriorityAboveNormal,
+};
+#else
 const osThreadAttr_t readerTask_attributes = {
     .name       = "ReaderTask",
     .stack_size = 512 * 4,
@@ -43,6 +100,32 @@ const osThreadAttr_t writerTask_attributes = {
     .stack_size = 512 * 4,
     .priority   = (osPriority_t) osPriorityAboveNormal,
 };
+#endif
+
+#if BRIDGE_REVERSE
+/* Same priority as the forward tasks: their yields rotate through these */
+const osThreadAttr_t revReaderTask_attributes = {
+    .name       = "RevReaderTask",
+    .stack_size = 256 * 4,
+    .priority   = (osPriority_t) osPriorityAboveNormal,
+};
+
+const osThreadAttr_t revWriterTask_attributes = {
+    .name       = "RevWriterTask",
+    .stack_size = 256 * 4,
+    .priority   = (osPriority_t) osPriorityAboveNormal,
+};
+#endif
+
+#if BRIDGE_RTOS_STATS
+/* Above the bridge so a saturated bridge cannot starve it; it runs for a
+ * few microseconds once per RTOS_STATS_PERIOD_MS */
+const osThreadAttr_t statsTask_attributes = {
+    .name       = "StatsTask",
+    .stack_size = 256 * 4,
+    .priority   = (osPriority_t) osPriorityHigh,
+};
+#endif
 
 /* ---- Private function prototypes --------------------------------------- */
 static void SystemClock_Config(void);
@@ -51,6 +134,9 @@ static void MX_GPIO_Init(void);
 /* ======================================================================== */
 int main(void)
 {
+    /* Load ITCM/DTCM sections before any hot code or data is touched */
+    tcm_init();
+
     /* HAL and cache initialisation (D/I-cache enabled in SystemInit) */
     HAL_Init();
 
@@ -60,15 +146,85 @@ int main(void)
     /* Initialise GPIO peripherals */
     MX_GPIO_Init();
 
-    /* Initialise ring buffer */
-    rb_init(&g_bridge_buf);
+    /* Cycle counter for block timestamps, strobe timing and profiling */
+    dwt_init();
+
+#if BRIDGE_RTOS_TRACE
+    /* Trace ring; must be set up before the first task is created */
+    rtos_trace_init();
+#endif
+
+#if BRIDGE_CALIBRATE
+    /* Measure CLKOUT on each CPU leg and derive its strobe timing */
+    fifo_calibrate();
+#endif
+
+#if BRIDGE_USE_BLOCKS
+    /* All blocks start out free */
+    blkq_init(&g_full_blocks);
+    if (!block_pool_init(g_block_pool, BRIDGE_BLOCK_COUNT, &g_free_blocks))
+    {
+        Error_Handler();
+    }
+#else
+    /* Initialise ring buffer over its AXI-SRAM storage */
+    if (!rb_init(&g_bridge_buf, g_bridge_storage, sizeof(g_bridge_storage)))
+    {
+        Error_Handler();
+    }
+#endif
+#if BRIDGE_REVERSE
+    if (!rb_init(&g_rev_buf, g_rev_storage, sizeof(g_rev_storage)))
+    {
+        Error_Handler();
+    }
+#endif
+
+#if BRIDGE_CRC
+    /* CRC unit + FIFB trackers for the forward stream */
+    fifo_crc_init();
+#endif
+#if BRIDGE_TELEMETRY
+    /* FIFT frame counters + FIFB framing of the FIFO#2 stream */
+    fifo_tele_init();
+#endif
+
+    /* RXF# / TXE# edge interrupts (task wake-ups or DMA gating) */
+    fifo_exti_init();
+
+#if BRIDGE_READER_DMA
+    /* TIM2 + DMA1 strobe engine for FIFO#1 (idle until ReaderTask arms it) */
+    fifo1_dma_init();
+#endif
+#if BRIDGE_WRITER_DMA
+    /* TIM8 + DMA1 strobe engine for FIFO#2 (idle until WriterTask arms it) */
+    fifo2_dma_init();
+#endif
 
     /* Initialise FreeRTOS kernel */
     osKernelInitialize();
 
     /* Create bridging tasks */
-    osThreadNew(StartReaderTask, NULL, &readerTask_attributes);
-    osThreadNew(StartWriterTask, NULL, &writerTask_attributes);
+#if BRIDGE_SINGLE_TASK
+    g_reader_thread = osThreadNew(StartBridgeTask, NULL, &bridgeTask_attributes);
+    g_writer_thread = g_reader_thread;
+#elif BRIDGE_PRBS_TEST
+    /* Self-test: checker on FIFO#1, generator on FIFO#2 (fifo_prbs.h) */
+    g_reader_thread = osThreadNew(StartPrbsCheckTask, NULL, &readerTask_attributes);
+    g_writer_thread = osThreadNew(StartPrbsGenTask, NULL, &writerTask_attributes);
+#else
+    g_reader_thread = osThreadNew(StartReaderTask, NULL, &readerTask_attributes);
+    g_writer_thread = osThreadNew(StartWriterTask, NULL, &writerTask_attributes);
+#endif
+#if BRIDGE_REVERSE
+    g_rev_reader_thread = osThreadNew(StartRevReaderTask, NULL,
+                                      &revReaderTask_attributes);
+    g_rev_writer_thread = osThreadNew(StartRevWriterTask, NULL,
+                                      &revWriterTask_attributes);
+#endif
+#if BRIDGE_RTOS_STATS
+    (void)osThreadNew(StartStatsTask, NULL, &statsTask_attributes);
+#endif
 
     /* Start scheduler – does not return */
     osKernelStart();
@@ -130,6 +286,9 @@ static void MX_GPIO_Init(void)
     __HAL_RCC_GPIOE_CLK_ENABLE();
     __HAL_RCC_GPIOF_CLK_ENABLE();
     __HAL_RCC_GPIOH_CLK_ENABLE();  /* OSC pins */
+#if BRIDGE_READER_DMA || BRIDGE_WRITER_DMA
+    __HAL_RCC_GPIOA_CLK_ENABLE();  /* CLKOUT to timer ETR */
+#endif
 
     /* ------------------------------------------------------------------
      * FIFO#1 data bus – PE0..PE7 : INPUT, no pull
@@ -139,6 +298,10 @@ static void MX_GPIO_Init(void)
     GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
     GPIO_InitStruct.Pull = GPIO_NOPULL;
     HAL_GPIO_Init(GPIOE, &GPIO_InitStruct);
+#if BRIDGE_REVERSE
+    /* Reverse writes turn PE0..PE7 into outputs (fifo_strobe.h) */
+    GPIOE->OSPEEDR |= 0x0000FFFFu;
+#endif
 
     /* ------------------------------------------------------------------
      * FIFO#2 data bus – PF0..PF7 : OUTPUT PP, no pull, high-speed
@@ -152,8 +315,8 @@ static void MX_GPIO_Init(void)
 
     /* ------------------------------------------------------------------
      * FIFO#1 control (GPIOC):
-     *   Inputs : PC0 (RXF#), PC1 (TXE#), PC4 (CLKOUT)
-     *   Outputs: PC2 (RD#), PC3 (WR#), PC5 (OE#)
+     *   Inputs : PC0 (RXF#), PC1 (TXE#, reverse), PC4 (CLKOUT)
+     *   Outputs: PC2 (RD#), PC3 (WR#, reverse), PC5 (OE#)
      * ------------------------------------------------------------------ */
     /* Inputs */
     GPIO_InitStruct.Pin  = GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_4;
@@ -169,10 +332,23 @@ static void MX_GPIO_Init(void)
     HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
     GPIOC->BSRR = GPIO_PIN_2 | GPIO_PIN_3 | GPIO_PIN_5; /* RD#=1, WR#=1, OE#=1 */
 
+#if BRIDGE_READER_DMA
+    /* ------------------------------------------------------------------
+     * FIFO#1 CLKOUT, second wire – PA5 : TIM2_ETR (AF1), starts each
+     * DMA strobe period (fifo_dma.h)
+     * ------------------------------------------------------------------ */
+    GPIO_InitStruct.Pin       = GPIO_PIN_5;
+    GPIO_InitStruct.Mode      = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Pull      = GPIO_NOPULL;
+    GPIO_InitStruct.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;
+    GPIO_InitStruct.Alternate = GPIO_AF1_TIM2;
+    HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+#endif
+
     /* ------------------------------------------------------------------
      * FIFO#2 control (GPIOD):
-     *   Inputs : PD0 (RXF# opt), PD1 (TXE#), PD4 (CLKOUT opt)
-     *   Outputs: PD2 (RD# opt), PD3 (WR#), PD5 (OE# opt)
+     *   Inputs : PD0 (RXF#, reverse), PD1 (TXE#), PD4 (CLKOUT)
+     *   Outputs: PD2 (RD#, reverse), PD3 (WR#), PD5 (OE#, reverse)
      * ------------------------------------------------------------------ */
     /* Inputs */
     GPIO_InitStruct.Pin  = GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_4;
@@ -187,6 +363,19 @@ static void MX_GPIO_Init(void)
     GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
     HAL_GPIO_Init(GPIOD, &GPIO_InitStruct);
     GPIOD->BSRR = GPIO_PIN_2 | GPIO_PIN_3 | GPIO_PIN_5; /* RD#=1, WR#=1, OE#=1 */
+
+#if BRIDGE_WRITER_DMA
+    /* ------------------------------------------------------------------
+     * FIFO#2 CLKOUT, second wire – PA0 : TIM8_ETR (AF3), starts each
+     * DMA strobe period (fifo_dma.h)
+     * ------------------------------------------------------------------ */
+    GPIO_InitStruct.Pin       = GPIO_PIN_0;
+    GPIO_InitStruct.Mode      = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Pull      = GPIO_NOPULL;
+    GPIO_InitStruct.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;
+    GPIO_InitStruct.Alternate = GPIO_AF3_TIM8;
+    HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+#endif
 }
 
 /* ======================================================================== */
@@ -0,0 +1,112 @@
+/**
+ * @file rtos_stats.c
+ * @brief StatsTask: per-task CPU load and stack high-water marks (see
+ *        rtos_stats.h).
+ *
+ * The kernel's per-task counters are 32-bit CYCCNT sums and wrap every
+ * ~8.9 s of run time.  Differences between two snapshots less than a wrap
+ * apart are still exact, so StatsTask keeps the last raw value per task
+ * and accumulates the differences into 64-bit totals.
+ */
+
+#include "rtos_stats.h"
+#include "cmsis_os.h"
+
+#if BRIDGE_RTOS_STATS
+
+rtos_stats_t g_rtos_stats;
+
+/* ---- Private state ----------------------------------------------------- */
+
+static TaskStatus_t s_status[RTOS_STATS_MAX_TASKS];
+static TaskHandle_t s_handle[RTOS_STATS_MAX_TASKS];    /* slot owners */
+static uint32_t     s_last_run[RTOS_STATS_MAX_TASKS];  /* by slot */
+static uint32_t     s_last_total;
+
+/* ---- Private helpers --------------------------------------------------- */
+
+/**
+ * @brief Slot of task @p h, claiming a free one the first time it is seen.
+ * @return Slot index, or RTOS_STATS_MAX_TASKS if all slots are taken.
+ *
+ * Tasks are never deleted in this firmware, so slots are never released.
+ */
+static uint32_t stats_slot(TaskHandle_t h)
+{
+    uint32_t i;
+
+    for (i = 0u; i < RTOS_STATS_MAX_TASKS && s_handle[i] != NULL; i++)
+    {
+        if (s_handle[i] == h)
+        {
+            return i;
+        }
+    }
+    if (i < RTOS_STATS_MAX_TASKS)
+    {
+        s_handle[i] = h;
+    }
+    return i;
+}
+
+/**
+ * @brief Take one snapshot and fold it into g_rtos_stats.
+ */
+static void stats_update(void)
+{
+    uint32_t    total;
+    UBaseType_t n = uxTaskGetSystemState(s_status, RTOS_STATS_MAX_TASKS,
+                                         &total);
+    uint32_t    period = total - s_last_total;
+
+    g_rtos_stats.seq++;
+    __asm volatile ("" ::: "memory");
+
+    g_rtos_stats.period = period;
+    g_rtos_stats.ntasks = (n != 0u) ? (uint32_t)n : uxTaskGetNumberOfTasks();
+    for (UBaseType_t i = 0u; i < n; i++)
+    {
+        const TaskStatus_t *ts   = &s_status[i];
+        uint32_t            slot = stats_slot(ts->xHandle);
+        if (slot >= RTOS_STATS_MAX_TASKS)
+        {
+            continue;
+        }
+
+        rtos_task_stats_t *t   = &g_rtos_stats.task[slot];
+        uint32_t           run = ts->ulRunTimeCounter - s_last_run[slot];
+
+        t->name       = ts->pcTaskName;
+        t->cycles    += run;
+        t->load       = (uint16_t)((period != 0u)
+                            ? ((uint64_t)run * 1000u) / period : 0u);
+        t->stack_free = (uint16_t)ts->usStackHighWaterMark;
+        t->priority   = (uint8_t)ts->uxCurrentPriority;
+        t->state      = (uint8_t)ts->eCurrentState;
+        s_last_run[slot] = ts->ulRunTimeCounter;
+    }
+
+    __asm volatile ("" ::: "memory");
+    g_rtos_stats.seq++;
+    s_last_total = total;
+}
+
+/* ======================================================================== */
+void StartStatsTask(void *argument)
+{
+    (void)argument;
+
+    TickType_t wake = xTaskGetTickCount();
+
+    /* Baseline; the first period's loads are only valid after one more */
+    stats_update();
+
+    for (;;)
+    {
+        vTaskDelayUntil(&wake, (TickType_t)((RTOS_STATS_PERIOD_MS *
+                                             configTICK_RATE_HZ) / 1000u));
+        stats_update();
+    }
+}
+
+#endif /* BRIDGE_RTOS_STATS */
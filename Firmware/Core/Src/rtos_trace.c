@@ -0,0 +1,63 @@
+/**
+ * @file rtos_trace.c
+ * @brief Trace ring set-up and task names (see rtos_trace.h).
+ *
+ * The ring is .bss, or DTCM with BRIDGE_DTCM_DATA=1.  In AXI-SRAM the
+ * newest records may still sit in the D-cache, which a debugger does not
+ * see; rtos_trace_stop() cleans the block for that reason.
+ */
+
+#include "rtos_trace.h"
+#include "tcm.h"
+
+#if BRIDGE_RTOS_TRACE
+
+rtos_trace_t g_rtos_trace BRIDGE_HOT_BSS __attribute__((aligned(32)));
+
+/* ======================================================================== */
+void rtos_trace_init(void)
+{
+    rtos_trace_t *t = &g_rtos_trace;
+
+    t->magic     = RTOS_TRACE_MAGIC;
+    t->version   = RTOS_TRACE_VERSION;
+    t->ntasks    = 0u;
+    t->max_tasks = RTOS_TRACE_MAX_TASKS;
+    t->len       = RTOS_TRACE_LEN;
+    t->core_hz   = SystemCoreClock;
+    t->head      = 0u;
+    t->stop      = 0u;
+}
+
+/* ======================================================================== */
+void rtos_trace_stop(void)
+{
+    g_rtos_trace.stop = 1u;
+    __DSB();
+    SCB_CleanDCache_by_Addr((uint32_t *)(void *)&g_rtos_trace,
+                            (int32_t)sizeof(g_rtos_trace));
+}
+
+/* ======================================================================== */
+void rtos_trace_task(uint32_t id, const char *name)
+{
+    rtos_trace_t *t = &g_rtos_trace;
+
+    if (t->ntasks >= RTOS_TRACE_MAX_TASKS)
+    {
+        return;
+    }
+
+    rtos_trace_task_t *e = &t->task[t->ntasks];
+    uint32_t           i;
+
+    e->id = (uint8_t)id;
+    for (i = 0u; i < RTOS_TRACE_NAME_LEN - 1u && name[i] != '\0'; i++)
+    {
+        e->name[i] = name[i];
+    }
+    e->name[i] = '\0';
+    t->ntasks++;
+}
+
+#endif /* BRIDGE_RTOS_TRACE */
@@ -0,0 +1,334 @@
+/**
+ * @file fifb_test.c
+ * @brief Host test for the FIFB stream parser (fifb.h).
+ *
+ * Builds a stream of transfers the way the PC sender frames them (good
+ * ones, one with a damaged header CRC, one with a damaged payload CRC,
+ * junk and false magic starts in between) and checks the verdicts, the
+ * transfer count and the skipped byte count:
+ *
+ *   - with the whole stream fed at once and in many random splits;
+ *   - with hdr_only set, where the payload must never reach the CRC;
+ *   - fifb_idle() between transfers, inside one and after a trailing
+ *     partial magic.
+ *
+ * Usage: fifb_test
+ * Exit status is 0 only if every case passes.
+ */
+
+#include "fifb.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+/* ---- Stream builder ---------------------------------------------------- */
+
+#define STREAM_MAX   (1u << 20)
+#define RESULTS_MAX  16u
+
+typedef struct {
+    uint8_t  buf[STREAM_MAX];
+    uint32_t len;
+    uint64_t junk;                  /**< Bytes the parser must skip */
+    fifb_result_t expect[RESULTS_MAX];
+    uint32_t nexpect;
+} stream_t;
+
+static stream_t g_stream;
+
+static void put(stream_t *s, const void *p, uint32_t n)
+{
+    if (s->len + n > STREAM_MAX) {
+        fprintf(stderr, "stream buffer too small\n");
+        exit(2);
+    }
+    memcpy(s->buf + s->len, p, n);
+    s->len += n;
+}
+
+static void put_le(stream_t *s, uint64_t v, uint32_t n)
+{
+    for (uint32_t i = 0u; i < n; i++) {
+        uint8_t b = (uint8_t)(v >> (8u * i));
+        put(s, &b, 1u);
+    }
+}
+
+/** Filler that cannot contain a magic byte (0x42, 0x46, 0x49) */
+static void put_filler(stream_t *s, uint32_t n, uint32_t seed)
+{
+    for (uint32_t i = 0u; i < n; i++) {
+        uint8_t b = (uint8_t)(((i + seed) * 2654435761u) >> 26);
+        put(s, &b, 1u);
+    }
+}
+
+/** Bytes outside any transfer */
+static void put_junk(stream_t *s, const void *p, uint32_t n)
+{
+    put(s, p, n);
+    s->junk += n;
+}
+
+/**
+ * @brief Append one transfer.  @p bad_hdr / @p bad_payload flip a bit in
+ *        the header CRC / trailer.
+ */
+static void put_transfer(stream_t *s, const char *name, uint32_t size,
+                         bool bad_hdr, bool bad_payload)
+{
+    uint32_t start = s->len;
+    uint32_t nlen  = (uint32_t)strlen(name);
+
+    put_le(s, FIFB_MAGIC, 4u);
+    put_le(s, FIFB_VERSION, 2u);
+    put_le(s, nlen, 2u);
+    put(s, name, nlen);
+    put_le(s, size, 8u);
+    uint32_t hcrc = fifb_crc32_sw(FIFB_CRC_INIT, s->buf + start,
+                                  s->len - start) ^ FIFB_CRC_INIT;
+    put_le(s, hcrc ^ (bad_hdr ? 1u : 0u), 4u);
+
+    uint32_t pstart = s->len;
+    put_filler(s, size, start);
+    uint32_t pcrc = fifb_crc32_sw(FIFB_CRC_INIT, s->buf + pstart, size) ^
+                    FIFB_CRC_INIT;
+    put_le(s, pcrc ^ (bad_payload ? 0x80000000u : 0u), 4u);
+
+    /* A bad header makes the parser hunt again, through payload and trailer */
+    if (bad_hdr) {
+        s->junk += size + 4u;
+        s->expect[s->nexpect++] = FIFB_BAD_HEADER;
+    } else {
+        s->expect[s->nexpect++] = bad_payload ? FIFB_BAD_PAYLOAD : FIFB_OK;
+    }
+}
+
+static void build_stream(stream_t *s)
+{
+    uint8_t junk[64];
+
+    memset(s, 0, sizeof *s);
+    for (uint32_t i = 0u; i < sizeof junk; i++) {
+        junk[i] = (uint8_t)(i * 7u);
+    }
+
+    put_junk(s, junk, 13u);
+    put_transfer(s, "a.bin", 100000u, false, false);
+    put_junk(s, "BFIBF", 5u);               /* false starts */
+    put_transfer(s, "bad-header.bin", 5000u, true, false);
+    put_transfer(s, "bad-payload.bin", 70000u, false, true);
+    put_transfer(s, "", 0u, false, false);  /* empty name and payload */
+    put_junk(s, junk, sizeof junk);
+    put_transfer(s, "b.bin", 4096u, false, false);
+    put_junk(s, junk, 3u);
+}
+
+/* ---- Tracker plumbing -------------------------------------------------- */
+
+static fifb_result_t g_result[RESULTS_MAX];
+static uint32_t      g_nresult;
+static uint64_t      g_crc_bytes;   /* bytes passed to the CRC function */
+
+static void on_done(fifb_tracker_t *t, fifb_result_t r)
+{
+    (void)t;
+    if (g_nresult < RESULTS_MAX) {
+        g_result[g_nresult] = r;
+    }
+    g_nresult++;
+}
+
+static uint32_t crc_counted(uint32_t crc, const uint8_t *p, uint32_t len)
+{
+    g_crc_bytes += len;
+    return fifb_crc32_sw(crc, p, len);
+}
+
+static void tracker_init(fifb_tracker_t *t, bool hdr_only)
+{
+    fifb_init(t, crc_counted, on_done);
+    t->hdr_only = hdr_only;
+    g_nresult   = 0u;
+    g_crc_bytes = 0u;
+}
+
+/** xorshift32 for split sizes */
+static uint32_t rnd(uint32_t *s)
+{
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return x;
+}
+
+/**
+ * @brief Feed the stream in pieces of 1..@p max_piece bytes (whole stream
+ *        if 0) and compare with the expected outcome.
+ */
+static int run_feed(const char *name, bool hdr_only, uint32_t max_piece,
+                    uint32_t seed)
+{
+    const stream_t *s = &g_stream;
+    fifb_tracker_t  t;
+
+    tracker_init(&t, hdr_only);
+    for (uint32_t pos = 0u; pos < s->len; ) {
+        uint32_t n = s->len - pos;
+        if (max_piece != 0u) {
+            uint32_t r = 1u + rnd(&seed) % max_piece;
+            n = (r < n) ? r : n;
+        }
+        fifb_feed(&t, s->buf + pos, n);
+        pos += n;
+    }
+
+    int ok = (g_nresult == s->nexpect && t.seq == s->nexpect &&
+              t.skipped == s->junk && fifb_idle(&t));
+    for (uint32_t i = 0u; ok && i < s->nexpect; i++) {
+        fifb_result_t want = s->expect[i];
+        if (hdr_only && want == FIFB_BAD_PAYLOAD) {
+            want = FIFB_OK;
+        }
+        ok = (g_result[i] == want);
+    }
+    if (!ok) {
+        printf("FAIL  %-24s %" PRIu32 " results, seq %" PRIu32
+               ", skipped %" PRIu64 " (want %" PRIu32 ", %" PRIu64 ")\n",
+               name, g_nresult, t.seq, t.skipped, s->nexpect, s->junk);
+        return 1;
+    }
+    return 0;
+}
+
+/* ---- Cases ------------------------------------------------------------- */
+
+static int case_crc(void)
+{
+    static const uint8_t check[] = "123456789";
+    uint32_t crc = fifb_crc32_sw(FIFB_CRC_INIT, check, 9u) ^ FIFB_CRC_INIT;
+
+    if (crc != 0xCBF43926u) {
+        printf("FAIL  crc32 check value %08" PRIX32 "\n", crc);
+        return 1;
+    }
+    printf("PASS  crc32 check value\n");
+    return 0;
+}
+
+static int case_whole(bool hdr_only)
+{
+    const char *name = hdr_only ? "whole stream, hdr_only" : "whole stream";
+
+    if (run_feed(name, hdr_only, 0u, 0u) != 0) {
+        return 1;
+    }
+    printf("PASS  %s\n", name);
+    return 0;
+}
+
+static int case_splits(bool hdr_only)
+{
+    static const uint32_t max_piece[] = { 1u, 3u, 7u, 64u, 1500u, 65536u };
+    const char *name = hdr_only ? "random splits, hdr_only" : "random splits";
+    uint32_t    runs = 0u;
+
+    for (uint32_t m = 0u; m < sizeof max_piece / sizeof max_piece[0]; m++) {
+        for (uint32_t seed = 1u; seed <= 8u; seed++) {
+            if (run_feed(name, hdr_only, max_piece[m], seed * 0x9E3779B9u)) {
+                return 1;
+            }
+            runs++;
+        }
+    }
+    printf("PASS  %s (%" PRIu32 " runs)\n", name, runs);
+    return 0;
+}
+
+/** hdr_only must hand only header bytes to the CRC function */
+static int case_hdr_only_crc(void)
+{
+    const stream_t *s = &g_stream;
+    fifb_tracker_t  t;
+
+    tracker_init(&t, false);
+    fifb_feed(&t, s->buf, s->len);
+    uint64_t full = g_crc_bytes;
+
+    tracker_init(&t, true);
+    fifb_feed(&t, s->buf, s->len);
+    uint64_t hdr = g_crc_bytes;
+
+    /* Payload CRCed with hdr_only clear: every good-header payload */
+    uint64_t payload = 100000u + 70000u + 0u + 4096u;
+    if (full - hdr != payload) {
+        printf("FAIL  hdr_only CRC bytes: %" PRIu64 " vs %" PRIu64 "\n",
+               hdr, full);
+        return 1;
+    }
+    printf("PASS  hdr_only skips the payload CRC\n");
+    return 0;
+}
+
+static int case_idle(void)
+{
+    fifb_tracker_t t;
+    int            ok = 1;
+
+    tracker_init(&t, false);
+    ok &= fifb_idle(&t);
+
+    /* Inside a transfer (half its header) */
+    fifb_feed(&t, g_stream.buf + 13u, 10u);
+    ok &= !fifb_idle(&t);
+
+    /* Trailing partial magic, one byte at a time, then a byte that breaks it */
+    tracker_init(&t, false);
+    fifb_feed(&t, (const uint8_t *)"xyz", 3u);
+    ok &= fifb_idle(&t);
+    for (uint32_t k = 0u; k < 3u; k++) {
+        fifb_feed(&t, (const uint8_t *)"BFI" + k, 1u);
+        ok &= !fifb_idle(&t);
+    }
+    fifb_feed(&t, (const uint8_t *)"x", 1u);
+    ok &= fifb_idle(&t);
+
+    /* "BFBF" still ends in the first two magic bytes */
+    fifb_feed(&t, (const uint8_t *)"BFBF", 4u);
+    ok &= !fifb_idle(&t);
+    fifb_feed(&t, (const uint8_t *)"Q", 1u);
+    ok &= fifb_idle(&t) && t.skipped == 12u && g_nresult == 0u;
+
+    if (!ok) {
+        printf("FAIL  fifb_idle\n");
+        return 1;
+    }
+    printf("PASS  fifb_idle\n");
+    return 0;
+}
+
+/* ======================================================================== */
+int main(void)
+{
+    int failures = 0;
+
+    build_stream(&g_stream);
+    printf("fifb_test: %" PRIu32 " transfers, %" PRIu32 " bytes\n",
+           g_stream.nexpect, g_stream.len);
+
+    failures += case_crc();
+    failures += case_whole(false);
+    failures += case_whole(true);
+    failures += case_splits(false);
+    failures += case_splits(true);
+    failures += case_hdr_only_crc();
+    failures += case_idle();
+
+    printf("%s (%d failure%s)\n", failures ? "FAILED" : "OK",
+           failures, failures == 1 ? "" : "s");
+    return failures ? 1 : 0;
+}
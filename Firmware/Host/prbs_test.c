@@ -0,0 +1,175 @@
+/**
+ * @file prbs_test.c
+ * @brief Host test for the PRBS-31 generator and checker (prbs.h).
+ *
+ * Checks that prbs31_next24() and prbs31_next() produce the same sequence,
+ * that the packed output satisfies the x^31 + x^28 recurrence bit by bit,
+ * and that a checker synchronised from any four bytes of a clean stream
+ * counts no errors, whatever the chunk sizes; one flipped bit must count
+ * as exactly one error.
+ *
+ * Usage: prbs_test [megabytes]   (default 16)
+ * Exit status is 0 only if every case passes.
+ */
+
+#include "prbs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+static const uint32_t g_seeds[] = {
+    1u, 0x7FFFFFFFu, 0x12345678u, 0x40000000u, 0x2AAAAAAAu,
+};
+#define NSEEDS  (sizeof g_seeds / sizeof g_seeds[0])
+
+/** xorshift32 for chunk sizes */
+static uint32_t rnd(uint32_t *s)
+{
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return x;
+}
+
+/** Bit @p n of a packed stream, earliest bit in the MSB of each byte */
+static inline uint32_t bit_at(const uint8_t *buf, uint64_t n)
+{
+    return (buf[n >> 3] >> (7u - (uint32_t)(n & 7u))) & 1u;
+}
+
+/* ---- Cases ------------------------------------------------------------- */
+
+static int case_next24(uint64_t bytes)
+{
+    for (uint32_t k = 0u; k < NSEEDS; k++) {
+        prbs31_t a;
+        prbs31_t b;
+
+        prbs31_init(&a, g_seeds[k]);
+        prbs31_init(&b, g_seeds[k]);
+        for (uint64_t i = 0u; i < bytes; i += 3u) {
+            uint32_t w  = prbs31_next24(&a);
+            uint32_t b0 = prbs31_next(&b);
+            uint32_t b1 = prbs31_next(&b);
+            uint32_t b2 = prbs31_next(&b);
+
+            if (w != ((b0 << 16) | (b1 << 8) | b2) || a.state != b.state) {
+                printf("FAIL  next24 = 3 x next   seed %08" PRIX32
+                       " byte %" PRIu64 "\n", g_seeds[k], i);
+                return 1;
+            }
+        }
+    }
+    printf("PASS  next24 = 3 x next\n");
+    return 0;
+}
+
+static int case_recurrence(uint8_t *buf, uint32_t len)
+{
+    for (uint32_t k = 0u; k < NSEEDS; k++) {
+        prbs31_t p;
+
+        prbs31_init(&p, g_seeds[k]);
+        prbs31_fill(&p, buf, len);
+        for (uint64_t n = 31u; n < (uint64_t)len * 8u; n++) {
+            if (bit_at(buf, n) != (bit_at(buf, n - 31u) ^
+                                   bit_at(buf, n - 28u))) {
+                printf("FAIL  x^31 + x^28 recurrence   seed %08" PRIX32
+                       " bit %" PRIu64 "\n", g_seeds[k], n);
+                return 1;
+            }
+        }
+    }
+    printf("PASS  x^31 + x^28 recurrence\n");
+    return 0;
+}
+
+/**
+ * @brief Check @p len bytes of @p buf from @p start in random chunks.
+ * @return Bit errors, or UINT32_MAX if the checker did not sync.
+ */
+static uint32_t check_stream(const uint8_t *buf, uint32_t len, uint32_t start,
+                             uint32_t seed)
+{
+    prbs31_t c;
+    uint32_t errors = 0u;
+
+    if (!prbs31_sync(&c, buf + start)) {
+        return UINT32_MAX;
+    }
+    for (uint32_t pos = start + 4u; pos < len; ) {
+        uint32_t n = 1u + rnd(&seed) % 2000u;
+        if (n > len - pos) {
+            n = len - pos;
+        }
+        errors += prbs31_check(&c, buf + pos, n);
+        pos    += n;
+    }
+    return errors;
+}
+
+static int case_check(uint8_t *buf, uint32_t len)
+{
+    static const uint32_t starts[] = { 0u, 1u, 2u, 3u, 1000u, 65537u };
+    static const uint8_t  zeros[4] = { 0u, 0u, 0u, 0u };
+    prbs31_t p;
+
+    for (uint32_t k = 0u; k < NSEEDS; k++) {
+        prbs31_init(&p, g_seeds[k]);
+        prbs31_fill(&p, buf, len);
+        for (uint32_t s = 0u; s < sizeof starts / sizeof starts[0]; s++) {
+            uint32_t e = check_stream(buf, len, starts[s], k + s + 1u);
+            if (e != 0u) {
+                printf("FAIL  sync + check, clean   seed %08" PRIX32
+                       " start %" PRIu32 ": %" PRIu32 " errors\n",
+                       g_seeds[k], starts[s], e);
+                return 1;
+            }
+        }
+    }
+    printf("PASS  sync + check, clean stream\n");
+
+    /* One flipped bit is one error */
+    buf[len / 2u] ^= 0x10u;
+    uint32_t e = check_stream(buf, len, 0u, 7u);
+    buf[len / 2u] ^= 0x10u;
+    if (e != 1u) {
+        printf("FAIL  sync + check, one flipped bit: %" PRIu32 " errors\n", e);
+        return 1;
+    }
+    printf("PASS  sync + check, one flipped bit\n");
+
+    if (prbs31_sync(&p, zeros)) {
+        printf("FAIL  sync on an all-zero stream\n");
+        return 1;
+    }
+    printf("PASS  no sync on an all-zero stream\n");
+    return 0;
+}
+
+/* ======================================================================== */
+int main(int argc, char **argv)
+{
+    uint64_t mb  = (argc > 1) ? strtoull(argv[1], NULL, 0) : 16u;
+    uint32_t len = 1u << 20;   /* stream kept in memory per seed */
+    uint8_t *buf = malloc(len);
+    int failures = 0;
+
+    if (buf == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 2;
+    }
+    printf("prbs_test: %" PRIu64 " MB per seed for next24\n", mb);
+
+    failures += case_next24(mb << 20);
+    failures += case_recurrence(buf, len);
+    failures += case_check(buf, len);
+    free(buf);
+
+    printf("%s (%d failure%s)\n", failures ? "FAILED" : "OK",
+           failures, failures == 1 ? "" : "s");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,331 @@
+/**
+ * @file rb_bench.c
+ * @brief Host microbenchmark for ring_buffer.h and its variants.
+ *
+ * Two measurements per API and buffer size:
+ *
+ *   ns/op  – one thread alternately fills and drains the buffer, so the
+ *            figure is the pure instruction cost of the API without
+ *            cross-core cache-line traffic.  One op moves one chunk
+ *            (1 byte for the byte API, 4/8 for the word API, BENCH_CHUNK
+ *            bytes otherwise).
+ *   MB/s   – a producer and a consumer thread stream through the buffer
+ *            concurrently, as ReaderTask and WriterTask do on the target.
+ *            A side that finds the buffer full/empty yields, so the figure
+ *            is meaningful on a single-core host too (it then measures
+ *            time-sliced hand-over, like the two tasks on the MCU).
+ *
+ * The host figures are not target figures: they are meant to compare one
+ * revision of the data structure with the next on the same machine.
+ *
+ * Usage: rb_bench [megabytes per run]   (default 256)
+ */
+
+#include "ring_buffer.h"
+#include "ring_buffer_dma.h"
+#include "bip_buffer.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <inttypes.h>
+
+/** Bytes per op for the bulk / zero-copy APIs (one FIFO burst) */
+#define BENCH_CHUNK  64u
+
+/* ---- Timing ------------------------------------------------------------ */
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/** Keep the optimiser from discarding consumed data */
+static volatile uint8_t g_sink;
+
+/* ---- APIs under test --------------------------------------------------- */
+
+typedef struct {
+    ring_buffer_t rb;
+    rbd_t         rbd;
+    bip_buffer_t  bb;
+    uint64_t      total;
+} bench_t;
+
+typedef struct {
+    const char *name;
+    int         kind;      /**< 0 = rb, 1 = rbd, 2 = bip */
+    uint32_t    op_bytes;  /**< Bytes moved per op */
+    uint32_t  (*produce)(bench_t *b, const uint8_t *src);  /**< 1 op or 0 */
+    uint32_t  (*consume)(bench_t *b, uint8_t *dst);        /**< 1 op or 0 */
+} api_t;
+
+static uint32_t rb_byte_produce(bench_t *b, const uint8_t *src)
+{
+    return rb_push(&b->rb, src[0]) ? 1u : 0u;
+}
+
+static uint32_t rb_byte_consume(bench_t *b, uint8_t *dst)
+{
+    return rb_pop(&b->rb, &dst[0]) ? 1u : 0u;
+}
+
+static uint32_t rb_bulk_produce(bench_t *b, const uint8_t *src)
+{
+    if (rb_free(&b->rb) < BENCH_CHUNK) {
+        return 0u;
+    }
+    return rb_write(&b->rb, src, BENCH_CHUNK) ? 1u : 0u;
+}
+
+static uint32_t rb_bulk_consume(bench_t *b, uint8_t *dst)
+{
+    if (rb_count(&b->rb) < BENCH_CHUNK) {
+        return 0u;
+    }
+    return rb_read(&b->rb, dst, BENCH_CHUNK) ? 1u : 0u;
+}
+
+/* Zero-copy: fill/drain in place the way the bridge tasks do */
+static uint32_t rb_zc_produce(bench_t *b, const uint8_t *src)
+{
+    uint8_t *p;
+    if (rb_reserve(&b->rb, &p) < BENCH_CHUNK) {
+        return 0u;
+    }
+    memcpy(p, src, BENCH_CHUNK);
+    rb_commit(&b->rb, BENCH_CHUNK);
+    return 1u;
+}
+
+static uint32_t rb_zc_consume(bench_t *b, uint8_t *dst)
+{
+    const uint8_t *p;
+    if (rb_peek(&b->rb, &p) < BENCH_CHUNK) {
+        return 0u;
+    }
+    memcpy(dst, p, BENCH_CHUNK);
+    rb_release(&b->rb, BENCH_CHUNK);
+    return 1u;
+}
+
+/* Word API: one op is one 4- or 8-byte push/pop */
+static uint32_t rb_u32_produce(bench_t *b, const uint8_t *src)
+{
+    uint32_t w;
+    memcpy(&w, src, sizeof(w));
+    return rb_push_u32(&b->rb, w) ? 1u : 0u;
+}
+
+static uint32_t rb_u32_consume(bench_t *b, uint8_t *dst)
+{
+    uint32_t w;
+    if (!rb_pop_u32(&b->rb, &w)) {
+        return 0u;
+    }
+    memcpy(dst, &w, sizeof(w));
+    return 1u;
+}
+
+static uint32_t rb_u64_produce(bench_t *b, const uint8_t *src)
+{
+    uint64_t w;
+    memcpy(&w, src, sizeof(w));
+    return rb_push_u64(&b->rb, w) ? 1u : 0u;
+}
+
+static uint32_t rb_u64_consume(bench_t *b, uint8_t *dst)
+{
+    uint64_t w;
+    if (!rb_pop_u64(&b->rb, &w)) {
+        return 0u;
+    }
+    memcpy(dst, &w, sizeof(w));
+    return 1u;
+}
+
+static uint32_t rbd_bulk_produce(bench_t *b, const uint8_t *src)
+{
+    if (rbd_free(&b->rbd) < BENCH_CHUNK) {
+        return 0u;
+    }
+    return rbd_write(&b->rbd, src, BENCH_CHUNK) ? 1u : 0u;
+}
+
+static uint32_t rbd_bulk_consume(bench_t *b, uint8_t *dst)
+{
+    if (rbd_count(&b->rbd) < BENCH_CHUNK) {
+        return 0u;
+    }
+    return rbd_read(&b->rbd, dst, BENCH_CHUNK) ? 1u : 0u;
+}
+
+static uint32_t bip_produce(bench_t *b, const uint8_t *src)
+{
+    uint8_t *p;
+    if (!bip_reserve(&b->bb, BENCH_CHUNK, &p)) {
+        return 0u;
+    }
+    memcpy(p, src, BENCH_CHUNK);
+    bip_commit(&b->bb, BENCH_CHUNK);
+    return 1u;
+}
+
+static uint32_t bip_consume(bench_t *b, uint8_t *dst)
+{
+    const uint8_t *p;
+    if (bip_peek(&b->bb, &p) < BENCH_CHUNK) {
+        return 0u;
+    }
+    memcpy(dst, p, BENCH_CHUNK);
+    bip_release(&b->bb, BENCH_CHUNK);
+    return 1u;
+}
+
+static const api_t k_apis[] = {
+    { "rb_byte",  0, 1u,          rb_byte_produce,  rb_byte_consume  },
+    { "rb_u32",   0, 4u,          rb_u32_produce,   rb_u32_consume   },
+    { "rb_u64",   0, 8u,          rb_u64_produce,   rb_u64_consume   },
+    { "rb_bulk",  0, BENCH_CHUNK, rb_bulk_produce,  rb_bulk_consume  },
+    { "rb_zc",    0, BENCH_CHUNK, rb_zc_produce,    rb_zc_consume    },
+    { "rbd_bulk", 1, BENCH_CHUNK, rbd_bulk_produce, rbd_bulk_consume },
+    { "bip",      2, BENCH_CHUNK, bip_produce,      bip_consume      },
+};
+
+static const uint32_t k_sizes[] = { 1024u, 16384u, 262144u };
+
+/* ---- Runs -------------------------------------------------------------- */
+
+static bool bench_init(bench_t *b, const api_t *api, uint8_t *storage,
+                       uint32_t size)
+{
+    memset(b, 0, sizeof *b);
+    switch (api->kind) {
+    case 0:  return rb_init(&b->rb, storage, size);
+    case 1:  return rbd_init(&b->rbd, storage, size, 0u);
+    default: return bip_init(&b->bb, storage, size);
+    }
+}
+
+/** Single thread: fill until full, drain until empty, repeat */
+static double run_single(bench_t *b, const api_t *api)
+{
+    uint8_t  chunk[BENCH_CHUNK] = { 0 };
+    uint64_t ops = b->total / api->op_bytes;
+    uint64_t done = 0u;
+
+    double t0 = now_s();
+    while (done < ops) {
+        uint64_t burst = 0u;
+        while (done + burst < ops && api->produce(b, chunk)) {
+            burst++;
+        }
+        for (uint64_t i = 0u; i < burst; i++) {
+            (void)api->consume(b, chunk);
+        }
+        g_sink = chunk[0];
+        done += burst;
+    }
+    double t1 = now_s();
+
+    /* Each op is counted once for produce and once for consume */
+    return (t1 - t0) * 1e9 / (double)(2u * ops);
+}
+
+typedef struct {
+    bench_t     *b;
+    const api_t *api;
+} thread_arg_t;
+
+static void *producer(void *arg)
+{
+    thread_arg_t *ta = arg;
+    uint8_t  chunk[BENCH_CHUNK] = { 0 };
+    uint64_t ops = ta->b->total / ta->api->op_bytes;
+
+    for (uint64_t i = 0u; i < ops; ) {
+        if (ta->api->produce(ta->b, chunk)) {
+            i++;
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *consumer(void *arg)
+{
+    thread_arg_t *ta = arg;
+    uint8_t  chunk[BENCH_CHUNK];
+    uint64_t ops = ta->b->total / ta->api->op_bytes;
+
+    for (uint64_t i = 0u; i < ops; ) {
+        if (ta->api->consume(ta->b, chunk)) {
+            i++;
+        } else {
+            sched_yield();
+        }
+    }
+    g_sink = chunk[0];
+    return NULL;
+}
+
+/** Two threads streaming concurrently; returns MB/s */
+static double run_threaded(bench_t *b, const api_t *api)
+{
+    thread_arg_t ta = { b, api };
+    pthread_t p, c;
+
+    double t0 = now_s();
+    pthread_create(&c, NULL, consumer, &ta);
+    pthread_create(&p, NULL, producer, &ta);
+    pthread_join(p, NULL);
+    pthread_join(c, NULL);
+    double t1 = now_s();
+
+    return (double)b->total / (t1 - t0) / 1e6;
+}
+
+/* ---- Main -------------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    uint64_t mb = (argc > 1) ? strtoull(argv[1], NULL, 0) : 256u;
+    static bench_t b;
+
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    printf("rb_bench: %" PRIu64 " MB per run, %u-byte chunks\n\n",
+           mb, BENCH_CHUNK);
+    printf("%-10s %8s %10s %10s %12s\n",
+           "api", "size", "op_bytes", "ns/op", "MB/s (2 thr)");
+
+    for (size_t a = 0; a < sizeof k_apis / sizeof k_apis[0]; a++) {
+        for (size_t s = 0; s < sizeof k_sizes / sizeof k_sizes[0]; s++) {
+            const api_t *api = &k_apis[a];
+            uint32_t size = k_sizes[s];
+            uint8_t *storage = aligned_alloc(RBD_CACHE_LINE, size);
+
+            if (!bench_init(&b, api, storage, size)) {
+                printf("%-10s %8" PRIu32 "  init rejected\n", api->name, size);
+                free(storage);
+                continue;
+            }
+            /* The byte API is ~BENCH_CHUNK times slower per byte */
+            b.total = (mb << 20) / ((api->op_bytes == 1u) ? 16u : 1u);
+            double ns = run_single(&b, api);
+
+            (void)bench_init(&b, api, storage, size);
+            b.total = (mb << 20) / ((api->op_bytes == 1u) ? 16u : 1u);
+            double mbps = run_threaded(&b, api);
+
+            printf("%-10s %8" PRIu32 " %10" PRIu32 " %10.2f %12.1f\n",
+                   api->name, size, api->op_bytes, ns, mbps);
+            free(storage);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,446 @@
+/**
+ * @file rb_stress.c
+ * @brief Host two-thread stress test for ring_buffer.h, ring_buffer_dma.h
+ *        and bip_buffer.h.
+ *
+ * One producer thread and one consumer thread move a position-keyed byte
+ * stream through each buffer API with randomly sized chunks.  The consumer
+ * checks every byte against its stream position, so a lost, duplicated or
+ * reordered byte is reported with the offset where it happened.
+ *
+ * Usage: rb_stress [megabytes per case]   (default 64)
+ * Exit status is 0 only if every case passes.
+ */
+
+#include "ring_buffer.h"
+#include "ring_buffer_dma.h"
+#include "bip_buffer.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+/* ---- Stream pattern ---------------------------------------------------- */
+
+/** Byte expected at stream position @p pos (depends on every bit of pos) */
+static inline uint8_t stream_byte(uint64_t pos)
+{
+    uint64_t x = pos * 0x9E3779B97F4A7C15ull;
+    return (uint8_t)(x >> 56);
+}
+
+/** xorshift32 for chunk sizes; each thread owns its own state */
+static inline uint32_t rnd(uint32_t *s)
+{
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return x;
+}
+
+/* ---- Test case plumbing ------------------------------------------------ */
+
+#define MAX_CHUNK  1500u
+
+typedef struct test_case test_case_t;
+
+struct test_case {
+    const char *name;
+    uint32_t    size;
+    /** Move up to @p n bytes of the stream in; returns bytes accepted */
+    uint32_t  (*produce)(test_case_t *tc, const uint8_t *src, uint32_t n);
+    /** Move up to @p n bytes out; returns bytes delivered */
+    uint32_t  (*consume)(test_case_t *tc, uint8_t *dst, uint32_t n);
+    void      (*check)(test_case_t *tc);   /**< Optional post-run check */
+
+    ring_buffer_t rb;
+    rbd_t         rbd;
+    bip_buffer_t  bb;
+
+    uint64_t          total;
+    volatile uint64_t error_at;  /**< UINT64_MAX while no error */
+    volatile int      failed;
+};
+
+/* ring_buffer.h – single-byte API */
+static uint32_t rb_byte_produce(test_case_t *tc, const uint8_t *src, uint32_t n)
+{
+    uint32_t i = 0u;
+    while (i < n && rb_push(&tc->rb, src[i])) {
+        i++;
+    }
+    return i;
+}
+
+static uint32_t rb_byte_consume(test_case_t *tc, uint8_t *dst, uint32_t n)
+{
+    uint32_t i = 0u;
+    while (i < n && rb_pop(&tc->rb, &dst[i])) {
+        i++;
+    }
+    return i;
+}
+
+/* ring_buffer.h – bulk copy API */
+static uint32_t rb_bulk_produce(test_case_t *tc, const uint8_t *src, uint32_t n)
+{
+    return rb_write(&tc->rb, src, n);
+}
+
+static uint32_t rb_bulk_consume(test_case_t *tc, uint8_t *dst, uint32_t n)
+{
+    return rb_read(&tc->rb, dst, n);
+}
+
+/* ring_buffer.h – zero-copy API */
+static uint32_t rb_zc_produce(test_case_t *tc, const uint8_t *src, uint32_t n)
+{
+    uint8_t *p;
+    uint32_t len = rb_reserve(&tc->rb, &p);
+    if (len > n) {
+        len = n;
+    }
+    memcpy(p, src, len);
+    rb_commit(&tc->rb, len);
+    return len;
+}
+
+static uint32_t rb_zc_consume(test_case_t *tc, uint8_t *dst, uint32_t n)
+{
+    const uint8_t *p;
+    uint32_t len = rb_peek(&tc->rb, &p);
+    if (len > n) {
+        len = n;
+    }
+    memcpy(dst, p, len);
+    rb_release(&tc->rb, len);
+    return len;
+}
+
+/* ring_buffer.h – word API; chunk tails shorter than a word go through the
+ * byte API, so words regularly straddle the physical end of the buffer */
+static uint32_t rb_u32_produce(test_case_t *tc, const uint8_t *src, uint32_t n)
+{
+    uint32_t i = 0u;
+    while (n - i >= 4u) {
+        uint32_t w;
+        memcpy(&w, &src[i], sizeof(w));
+        if (!rb_push_u32(&tc->rb, w)) {
+            return i;
+        }
+        i += 4u;
+    }
+    return i + rb_byte_produce(tc, src + i, n - i);
+}
+
+static uint32_t rb_u32_consume(test_case_t *tc, uint8_t *dst, uint32_t n)
+{
+    uint32_t i = 0u;
+    uint32_t w;
+    while (n - i >= 4u && rb_pop_u32(&tc->rb, &w)) {
+        memcpy(&dst[i], &w, sizeof(w));
+        i += 4u;
+    }
+    /* Fewer than a word requested or stored: take what is there */
+    return i + rb_byte_consume(tc, dst + i, n - i);
+}
+
+static uint32_t rb_u64_produce(test_case_t *tc, const uint8_t *src, uint32_t n)
+{
+    uint32_t i = 0u;
+    while (n - i >= 8u) {
+        uint64_t w;
+        memcpy(&w, &src[i], sizeof(w));
+        if (!rb_push_u64(&tc->rb, w)) {
+            return i;
+        }
+        i += 8u;
+    }
+    return i + rb_byte_produce(tc, src + i, n - i);
+}
+
+static uint32_t rb_u64_consume(test_case_t *tc, uint8_t *dst, uint32_t n)
+{
+    uint32_t i = 0u;
+    uint64_t w;
+    while (n - i >= 8u && rb_pop_u64(&tc->rb, &w)) {
+        memcpy(&dst[i], &w, sizeof(w));
+        i += 8u;
+    }
+    /* Fewer than a word requested or stored: take what is there */
+    return i + rb_byte_consume(tc, dst + i, n - i);
+}
+
+#if RB_ENABLE_STATS
+/* Every byte went through, so occupancy must have been sampled */
+static void rb_stats_check(test_case_t *tc)
+{
+    rb_stats_t st;
+    rb_stats_get(&tc->rb, &st);
+    uint32_t sum = 0u;
+    for (uint32_t i = 0u; i < RB_STATS_HIST_BINS; i++) {
+        sum += st.hist[i];
+    }
+    if (st.samples == 0u || sum != st.samples || st.peak > tc->rb.mask) {
+        printf("    stats inconsistent: samples=%" PRIu32 " hist=%" PRIu32
+               " peak=%" PRIu32 "\n", st.samples, sum, st.peak);
+        tc->failed = 1;
+    }
+}
+#endif
+
+/* ring_buffer_dma.h – bulk copy API (both sides declared DMA to exercise
+ * the cache hooks, which are no-ops on the host) */
+static uint32_t rbd_bulk_produce(test_case_t *tc, const uint8_t *src, uint32_t n)
+{
+    return rbd_write(&tc->rbd, src, n);
+}
+
+static uint32_t rbd_bulk_consume(test_case_t *tc, uint8_t *dst, uint32_t n)
+{
+    return rbd_read(&tc->rbd, dst, n);
+}
+
+/* ring_buffer_dma.h – zero-copy API */
+static uint32_t rbd_zc_produce(test_case_t *tc, const uint8_t *src, uint32_t n)
+{
+    uint8_t *p;
+    uint32_t len = rbd_reserve(&tc->rbd, &p);
+    if (len > n) {
+        len = n;
+    }
+    memcpy(p, src, len);
+    rbd_commit(&tc->rbd, len);
+    return len;
+}
+
+static uint32_t rbd_zc_consume(test_case_t *tc, uint8_t *dst, uint32_t n)
+{
+    const uint8_t *p;
+    uint32_t len = rbd_peek(&tc->rbd, &p);
+    if (len > n) {
+        len = n;
+    }
+    memcpy(dst, p, len);
+    rbd_release(&tc->rbd, len);
+    return len;
+}
+
+/* bip_buffer.h – exact-size reservations (all-or-nothing) */
+static uint32_t bip_exact_produce(test_case_t *tc, const uint8_t *src, uint32_t n)
+{
+    uint8_t *p;
+    if (n > tc->size / 3u) {
+        n = tc->size / 3u;
+    }
+    if (!bip_reserve(&tc->bb, n, &p)) {
+        return 0u;
+    }
+    memcpy(p, src, n);
+    bip_commit(&tc->bb, n);
+    return n;
+}
+
+/* bip_buffer.h – largest-region reservations, partially committed */
+static uint32_t bip_max_produce(test_case_t *tc, const uint8_t *src, uint32_t n)
+{
+    uint8_t *p;
+    uint32_t len = bip_reserve_max(&tc->bb, &p);
+    if (len == 0u) {
+        return 0u;
+    }
+    if (len > n) {
+        len = n;
+    }
+    memcpy(p, src, len);
+    bip_commit(&tc->bb, len);
+    return len;
+}
+
+static uint32_t bip_consume(test_case_t *tc, uint8_t *dst, uint32_t n)
+{
+    const uint8_t *p;
+    uint32_t len = bip_peek(&tc->bb, &p);
+    if (len > n) {
+        len = n;
+    }
+    memcpy(dst, p, len);
+    bip_release(&tc->bb, len);
+    return len;
+}
+
+/* ---- Threads ----------------------------------------------------------- */
+
+static void *producer(void *arg)
+{
+    test_case_t *tc = arg;
+    uint8_t  src[MAX_CHUNK];
+    uint32_t seed = 0x12345678u;
+    uint64_t pos  = 0u;
+
+    while (pos < tc->total && !tc->failed) {
+        uint32_t n = 1u + rnd(&seed) % MAX_CHUNK;
+        if (n > tc->total - pos) {
+            n = (uint32_t)(tc->total - pos);
+        }
+        for (uint32_t i = 0u; i < n; i++) {
+            src[i] = stream_byte(pos + i);
+        }
+        uint32_t done = 0u;
+        while (done < n && !tc->failed) {
+            uint32_t k = tc->produce(tc, src + done, n - done);
+            if (k == 0u) {
+                sched_yield();
+            }
+            done += k;
+        }
+        pos += done;
+    }
+    return NULL;
+}
+
+static void *consumer(void *arg)
+{
+    test_case_t *tc = arg;
+    uint8_t  dst[MAX_CHUNK];
+    uint32_t seed = 0x9ABCDEF0u;
+    uint64_t pos  = 0u;
+
+    while (pos < tc->total && !tc->failed) {
+        uint32_t n = 1u + rnd(&seed) % MAX_CHUNK;
+        uint32_t k = tc->consume(tc, dst, n);
+        if (k == 0u) {
+            sched_yield();
+            continue;
+        }
+        for (uint32_t i = 0u; i < k; i++) {
+            if (dst[i] != stream_byte(pos + i)) {
+                tc->error_at = pos + i;
+                tc->failed   = 1;
+                return NULL;
+            }
+        }
+        pos += k;
+    }
+
+    /* Nothing may be left over once the whole stream has been consumed */
+    if (!tc->failed && tc->consume(tc, dst, 1u) != 0u) {
+        tc->error_at = pos;
+        tc->failed   = 1;
+    }
+    return NULL;
+}
+
+static int run_case(test_case_t *tc)
+{
+    pthread_t p, c;
+
+    tc->error_at = UINT64_MAX;
+    tc->failed   = 0;
+
+    pthread_create(&c, NULL, consumer, tc);
+    pthread_create(&p, NULL, producer, tc);
+    pthread_join(p, NULL);
+    pthread_join(c, NULL);
+
+    if (!tc->failed && tc->check != NULL) {
+        tc->check(tc);
+    }
+
+    if (tc->failed) {
+        if (tc->error_at != UINT64_MAX) {
+            printf("FAIL  %-12s size=%-7" PRIu32 " mismatch at byte %" PRIu64 "\n",
+                   tc->name, tc->size, tc->error_at);
+        } else {
+            printf("FAIL  %-12s size=%-7" PRIu32 "\n", tc->name, tc->size);
+        }
+        return 1;
+    }
+    printf("PASS  %-12s size=%-7" PRIu32 " %" PRIu64 " bytes\n",
+           tc->name, tc->size, tc->total);
+    return 0;
+}
+
+/* ---- Main -------------------------------------------------------------- */
+
+enum { KIND_RB, KIND_RBD, KIND_BIP };
+
+typedef struct {
+    const char *name;
+    int         kind;
+    uint32_t  (*produce)(test_case_t *, const uint8_t *, uint32_t);
+    uint32_t  (*consume)(test_case_t *, uint8_t *, uint32_t);
+} api_t;
+
+static const api_t k_apis[] = {
+    { "rb_byte",   KIND_RB,  rb_byte_produce,   rb_byte_consume  },
+    { "rb_bulk",   KIND_RB,  rb_bulk_produce,   rb_bulk_consume  },
+    { "rb_zc",     KIND_RB,  rb_zc_produce,     rb_zc_consume    },
+    { "rb_u32",    KIND_RB,  rb_u32_produce,    rb_u32_consume   },
+    { "rb_u64",    KIND_RB,  rb_u64_produce,    rb_u64_consume   },
+    { "rbd_bulk",  KIND_RBD, rbd_bulk_produce,  rbd_bulk_consume },
+    { "rbd_zc",    KIND_RBD, rbd_zc_produce,    rbd_zc_consume   },
+    { "bip_exact", KIND_BIP, bip_exact_produce, bip_consume      },
+    { "bip_max",   KIND_BIP, bip_max_produce,   bip_consume      },
+};
+
+/* Small sizes force constant wrap-around and full/empty transitions */
+static const uint32_t k_sizes[] = { 64u, 1024u, 4096u, 65536u };
+
+int main(int argc, char **argv)
+{
+    uint64_t mb = (argc > 1) ? strtoull(argv[1], NULL, 0) : 64u;
+    int failures = 0;
+
+    printf("rb_stress: %" PRIu64 " MB per case%s\n", mb,
+           RB_ENABLE_STATS ? " (RB_ENABLE_STATS=1)" : "");
+
+    for (size_t a = 0; a < sizeof k_apis / sizeof k_apis[0]; a++) {
+        for (size_t s = 0; s < sizeof k_sizes / sizeof k_sizes[0]; s++) {
+            static test_case_t tc;
+            uint32_t size = k_sizes[s];
+            uint8_t *storage = aligned_alloc(RBD_CACHE_LINE, size);
+            bool ok = false;
+
+            memset(&tc, 0, sizeof tc);
+            tc.name    = k_apis[a].name;
+            tc.size    = size;
+            tc.produce = k_apis[a].produce;
+            tc.consume = k_apis[a].consume;
+            tc.total   = mb << 20;
+
+            switch (k_apis[a].kind) {
+            case KIND_RB:
+                ok = rb_init(&tc.rb, storage, size);
+#if RB_ENABLE_STATS
+                tc.check = rb_stats_check;
+#endif
+                break;
+            case KIND_RBD:
+                ok = rbd_init(&tc.rbd, storage, size,
+                              RBD_PRODUCER_DMA | RBD_CONSUMER_DMA);
+                break;
+            default:
+                ok = bip_init(&tc.bb, storage, size);
+                break;
+            }
+
+            if (!ok) {
+                printf("FAIL  %-12s size=%-7" PRIu32 " init rejected\n",
+                       tc.name, size);
+                failures++;
+            } else {
+                failures += run_case(&tc);
+            }
+            free(storage);
+        }
+    }
+
+    printf("%s (%d failure%s)\n", failures ? "FAILED" : "OK",
+           failures, failures == 1 ? "" : "s");
+    return failures ? 1 : 0;
+}
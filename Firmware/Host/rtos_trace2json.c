@@ -0,0 +1,346 @@
+/**
+ * @file rtos_trace2json.c
+ * @brief Decode a g_rtos_trace dump (rtos_trace.h) into a Chrome trace.
+ *
+ * Output is Trace Event Format JSON for ui.perfetto.dev or
+ * chrome://tracing:
+ *
+ *   one track per task    a slice for every time slice it ran, with
+ *                         args.out = "yield" (still ready) or "block"
+ *   instants on a task    "notify <task>" (sent), "wait" (blocked on a
+ *                         notification)
+ *   "ISR" track           "IRQ <n> -> <task>" for notifications from ISRs
+ *   "Tick" track          SysTick
+ *
+ * A summary goes to stderr: per task, the number of slices, their mean
+ * and longest length, how they ended, and the wake-up latency from a
+ * notification to the task running.
+ *
+ * The dump is read field by field (little-endian), so it does not depend
+ * on the host's struct layout.
+ *
+ * Usage: rtos_trace2json trace.bin > trace.json
+ */
+
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ---- Dump format (keep in step with Core/Inc/rtos_trace.h) ------------- */
+
+#define TRACE_MAGIC       0x46495452u   /* "FITR" */
+#define TRACE_VERSION     1u
+#define TRACE_HDR_LEN     24u
+#define TRACE_TASK_LEN    16u
+#define TRACE_REC_LEN     8u
+#define TRACE_NAME_LEN    15u
+
+enum {
+    EV_SWITCH_IN  = 1,
+    EV_SWITCH_OUT = 2,
+    EV_TICK       = 3,
+    EV_NOTIFY     = 4,
+    EV_NOTIFY_ISR = 5,
+    EV_WAIT       = 6,
+};
+
+/** Track ids of the non-task tracks (task ids are 0..255) */
+#define TID_ISR   1000
+#define TID_TICK  1001
+
+/* ---- Per-task state ---------------------------------------------------- */
+
+typedef struct {
+    char     name[TRACE_NAME_LEN + 1];
+    bool     seen;
+    bool     running;
+    uint64_t in;          /* start of the open slice */
+    bool     waiting;     /* blocked for a notification */
+    bool     woken;       /* ... and notified at woken_at */
+    uint64_t woken_at;
+    uint32_t slices;
+    uint32_t yields;
+    uint32_t blocks;
+    uint64_t run;         /* cycles in closed slices */
+    uint64_t longest;
+    uint32_t wakes;
+    uint64_t wake_sum;
+    uint64_t wake_max;
+} task_t;
+
+static task_t   g_task[256];
+static uint32_t g_hz;
+static bool     g_first_event = true;
+
+/* ---- Helpers ----------------------------------------------------------- */
+
+static uint32_t rd16(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+static uint32_t rd32(const uint8_t *p)
+{
+    return rd16(p) | (rd16(p + 2) << 16);
+}
+
+static double us(uint64_t cycles)
+{
+    return (double)cycles * 1e6 / (double)g_hz;
+}
+
+static const char *task_name(uint32_t id)
+{
+    task_t *t = &g_task[id & 0xFFu];
+
+    if (t->name[0] == '\0') {
+        snprintf(t->name, sizeof t->name, "task %" PRIu32, id);
+    }
+    return t->name;
+}
+
+/** Print one element of the traceEvents array */
+__attribute__((format(printf, 1, 2)))
+static void event(const char *fmt, ...)
+{
+    va_list ap;
+
+    printf("%s\n  ", g_first_event ? "" : ",");
+    g_first_event = false;
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+}
+
+static void thread_name(int tid, const char *name)
+{
+    event("{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\","
+          "\"args\":{\"name\":\"%s\"}}", tid, name);
+}
+
+static void slice_end(uint32_t id, uint64_t now, const char *how)
+{
+    task_t  *t   = &g_task[id];
+    uint64_t len = now - t->in;
+
+    if (!t->running) {
+        return;
+    }
+    t->running = false;
+    t->slices++;
+    t->run += len;
+    if (len > t->longest) {
+        t->longest = len;
+    }
+    event("{\"ph\":\"X\",\"pid\":1,\"tid\":%" PRIu32 ",\"name\":\"%s\","
+          "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"out\":\"%s\"}}",
+          id, task_name(id), us(t->in), us(len), how);
+}
+
+/* ---- Decoder ----------------------------------------------------------- */
+
+static int decode(const uint8_t *buf, size_t size)
+{
+    if (size < TRACE_HDR_LEN || rd32(buf) != TRACE_MAGIC) {
+        fprintf(stderr, "not an rtos_trace dump (bad magic)\n");
+        return 1;
+    }
+    if (rd16(buf + 4) != TRACE_VERSION) {
+        fprintf(stderr, "unsupported version %" PRIu32 "\n", rd16(buf + 4));
+        return 1;
+    }
+
+    uint32_t ntasks    = buf[6];
+    uint32_t max_tasks = buf[7];
+    uint32_t len       = rd32(buf + 8);
+    uint32_t head      = rd32(buf + 16);
+    size_t   rec_off   = TRACE_HDR_LEN + (size_t)max_tasks * TRACE_TASK_LEN;
+
+    g_hz = rd32(buf + 12);
+    if (len == 0u || (len & (len - 1u)) != 0u || g_hz == 0u ||
+        ntasks > max_tasks ||
+        size < rec_off + (size_t)len * TRACE_REC_LEN) {
+        fprintf(stderr, "truncated or corrupt dump\n");
+        return 1;
+    }
+
+    for (uint32_t i = 0; i < ntasks; i++) {
+        const uint8_t *e = buf + TRACE_HDR_LEN + i * TRACE_TASK_LEN;
+        task_t        *t = &g_task[e[0]];
+
+        memcpy(t->name, e + 1, TRACE_NAME_LEN);
+        t->name[TRACE_NAME_LEN] = '\0';
+    }
+
+    /* Oldest record first; head counts every record ever written */
+    uint32_t n     = (head < len) ? head : len;
+    uint32_t first = head - n;
+
+    if (n == 0u) {
+        fprintf(stderr, "trace is empty\n");
+        return 1;
+    }
+
+    printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    event("{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\","
+          "\"args\":{\"name\":\"FIFO bridge\"}}");
+    thread_name(TID_ISR, "ISR");
+    thread_name(TID_TICK, "Tick");
+
+    /* Unwrap CYCCNT: consecutive records are < 8.9 s apart (tick) */
+    uint32_t prev = rd32(buf + rec_off +
+                         (size_t)(first & (len - 1u)) * TRACE_REC_LEN);
+    uint64_t now  = 0;
+    int      cur  = -1;   /* running task, -1: not known yet */
+
+    for (uint32_t i = 0; i < n; i++) {
+        const uint8_t *r    = buf + rec_off +
+                              (size_t)((first + i) & (len - 1u)) * TRACE_REC_LEN;
+        uint32_t       type = r[4];
+        uint32_t       id   = r[5];
+        uint32_t       arg  = rd16(r + 6);
+        task_t        *t    = &g_task[id];
+
+        now += (uint32_t)(rd32(r) - prev);
+        prev = rd32(r);
+
+        if (!t->seen) {
+            t->seen = true;
+            thread_name((int)id, task_name(id));
+        }
+
+        switch (type) {
+        case EV_SWITCH_IN:
+            t->running = true;
+            t->in      = now;
+            cur        = (int)id;
+            if (t->woken) {
+                uint64_t lat = now - t->woken_at;
+                t->wakes++;
+                t->wake_sum += lat;
+                if (lat > t->wake_max) {
+                    t->wake_max = lat;
+                }
+            }
+            t->waiting = false;
+            t->woken   = false;
+            break;
+        case EV_SWITCH_OUT:
+            if (arg != 0u) {
+                t->yields++;
+            } else {
+                t->blocks++;
+            }
+            slice_end(id, now, arg != 0u ? "yield" : "block");
+            cur = -1;
+            break;
+        case EV_TICK:
+            event("{\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,"
+                  "\"name\":\"tick\",\"ts\":%.3f,\"args\":{\"tick\":%" PRIu32 "}}",
+                  TID_TICK, us(now), arg);
+            break;
+        case EV_NOTIFY:
+            if (t->waiting && !t->woken) {
+                t->woken    = true;
+                t->woken_at = now;
+            }
+            event("{\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,"
+                  "\"name\":\"notify %s\",\"ts\":%.3f}",
+                  cur >= 0 ? cur : TID_ISR, task_name(id), us(now));
+            break;
+        case EV_NOTIFY_ISR:
+            if (t->waiting && !t->woken) {
+                t->woken    = true;
+                t->woken_at = now;
+            }
+            event("{\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,"
+                  "\"name\":\"IRQ %d -> %s\",\"ts\":%.3f}",
+                  TID_ISR, (int)arg - 16, task_name(id), us(now));
+            break;
+        case EV_WAIT:
+            t->waiting = true;
+            t->woken   = false;
+            event("{\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%" PRIu32 ","
+                  "\"name\":\"wait\",\"ts\":%.3f}", id, us(now));
+            break;
+        default:
+            fprintf(stderr, "record %" PRIu32 ": unknown type %" PRIu32 "\n",
+                    first + i, type);
+            break;
+        }
+    }
+
+    /* Close the slice still running at the end of the trace */
+    if (cur >= 0) {
+        slice_end((uint32_t)cur, now, "end");
+    }
+    printf("\n]}\n");
+
+    /* ---- Summary ---- */
+    fprintf(stderr, "%" PRIu32 " records over %.1f us at %" PRIu32 " Hz%s\n",
+            n, us(now), g_hz, head > len ? " (ring wrapped)" : "");
+    fprintf(stderr, "%-15s %7s %6s %10s %10s %7s %7s %10s %10s\n",
+            "task", "slices", "cpu%", "mean us", "max us", "yields", "blocks",
+            "wake us", "wake max");
+    for (uint32_t id = 0; id < 256u; id++) {
+        const task_t *t = &g_task[id];
+
+        if (!t->seen) {
+            continue;
+        }
+        fprintf(stderr, "%-15s %7" PRIu32 " %6.1f %10.3f %10.3f %7" PRIu32
+                " %7" PRIu32 " %10.3f %10.3f\n",
+                t->name, t->slices,
+                now ? 100.0 * (double)t->run / (double)now : 0.0,
+                t->slices ? us(t->run) / t->slices : 0.0, us(t->longest),
+                t->yields, t->blocks,
+                t->wakes ? us(t->wake_sum) / t->wakes : 0.0, us(t->wake_max));
+    }
+    return 0;
+}
+
+/* ======================================================================== */
+int main(int argc, char **argv)
+{
+    if (argc != 2) {
+        fprintf(stderr, "usage: rtos_trace2json trace.bin > trace.json\n");
+        return 2;
+    }
+
+    FILE *f = fopen(argv[1], "rb");
+    if (f == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    size_t   cap  = 1u << 16;
+    size_t   size = 0;
+    uint8_t *buf  = malloc(cap);
+
+    while (buf != NULL) {
+        size += fread(buf + size, 1, cap - size, f);
+        if (size < cap) {
+            break;
+        }
+
+        uint8_t *grown = realloc(buf, cap * 2u);
+        if (grown == NULL) {
+            free(buf);
+        }
+        buf  = grown;
+        cap *= 2u;
+    }
+    fclose(f);
+    if (buf == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    int rc = decode(buf, size);
+    free(buf);
+    return rc;
+}
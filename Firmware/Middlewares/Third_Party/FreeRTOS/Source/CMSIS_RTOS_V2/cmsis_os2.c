@@ -1,11 +1,13 @@
 /*
  * cmsis_os2.c – CMSIS-RTOS2 wrapper over FreeRTOS for FIFO_Bridge.
  *
- * Implements the four CMSIS-RTOS2 functions used by main.c and fifo_bridge.c:
+ * Implements the CMSIS-RTOS2 functions used by main.c and fifo_bridge.c:
  *   osKernelInitialize  →  (no-op; FreeRTOS initialises implicitly)
  *   osKernelStart       →  vTaskStartScheduler()
  *   osThreadNew         →  xTaskCreate()
  *   osThreadYield       →  taskYIELD()
+ *   osThreadFlagsSet    →  xTaskNotify[FromISR]( eSetBits )
+ *   osThreadFlagsWait   →  xTaskNotifyWait()
  *
  * CMSIS-RTOS2 priority mapping (0..56) → FreeRTOS priority (0..configMAX_PRIORITIES-1):
  *   osPriorityNormal (24) → configMAX_PRIORITIES/2
@@ -46,6 +48,15 @@ static UBaseType_t prvCMSIS2FreeRTOSPriority( osPriority_t cmsis_prio )
     return ( UBaseType_t ) freertos_prio;
 }
 
+/* Return non-zero when executing in handler (ISR) mode. */
+static inline uint32_t prvIsInsideISR( void )
+{
+    uint32_t ulIPSR;
+
+    __asm volatile ( "mrs %0, ipsr" : "=r" ( ulIPSR ) );
+    return ulIPSR;
+}
+
 /* ======================================================================== */
 
 /**
@@ -146,3 +157,103 @@ osStatus_t osThreadYield( void )
     taskYIELD();
     return osOK;
 }
+
+/* ----------------------------------------------------------------------- */
+
+/**
+ * @brief  Set thread flags of a thread.
+ *
+ * Thread flags are the task's default notification value used as a bit
+ * field (eSetBits).  Safe to call from an ISR whose priority is at or below
+ * configMAX_SYSCALL_INTERRUPT_PRIORITY; a context switch is requested on ISR
+ * exit if a higher-priority task was woken.
+ */
+uint32_t osThreadFlagsSet( osThreadId_t thread_id, uint32_t flags )
+{
+    TaskHandle_t hTask = ( TaskHandle_t ) thread_id;
+    uint32_t     rflags;
+    BaseType_t   yield;
+
+    if( ( hTask == NULL ) || ( ( flags & osFlagsError ) != 0U ) )
+    {
+        return osFlagsErrorParameter;
+    }
+
+    rflags = 0U;
+
+    if( prvIsInsideISR() != 0U )
+    {
+        yield = pdFALSE;
+        ( void ) xTaskGenericNotifyFromISR( hTask, tskDEFAULT_INDEX_TO_NOTIFY,
+                                            flags, eSetBits, &rflags, &yield );
+        rflags |= flags;
+        portYIELD_FROM_ISR( yield );
+    }
+    else
+    {
+        ( void ) xTaskGenericNotify( hTask, tskDEFAULT_INDEX_TO_NOTIFY,
+                                     flags, eSetBits, &rflags );
+        rflags |= flags;
+    }
+
+    return rflags;
+}
+
+/* ----------------------------------------------------------------------- */
+
+/**
+ * @brief  Wait for any of the specified thread flags of the current thread.
+ *
+ * Only osFlagsWaitAny semantics are implemented (optionally with
+ * osFlagsNoClear); osFlagsWaitAll returns osFlagsErrorParameter.  Flags
+ * that arrive but are not waited for do not end the wait; the remaining
+ * timeout is recomputed and the task blocks again.
+ */
+uint32_t osThreadFlagsWait( uint32_t flags, uint32_t options, uint32_t timeout )
+{
+    uint32_t   clear;
+    uint32_t   nval;
+    uint32_t   rflags;
+    TickType_t t0;
+    TickType_t td;
+
+    if( ( prvIsInsideISR() != 0U ) ||
+        ( ( flags & osFlagsError ) != 0U ) ||
+        ( ( options & osFlagsWaitAll ) != 0U ) )
+    {
+        return osFlagsErrorParameter;
+    }
+
+    clear = ( ( options & osFlagsNoClear ) == 0U ) ? flags : 0U;
+    t0    = xTaskGetTickCount();
+    td    = ( TickType_t ) timeout;
+
+    for( ; ; )
+    {
+        if( xTaskNotifyWait( 0U, clear, &nval, td ) != pdPASS )
+        {
+            rflags = ( timeout == 0U ) ? osFlagsErrorResource : osFlagsErrorTimeout;
+            break;
+        }
+
+        if( ( nval & flags ) != 0U )
+        {
+            rflags = nval;
+            break;
+        }
+
+        /* Woken by flags we are not waiting for – block for the rest */
+        if( timeout != osWaitForever )
+        {
+            TickType_t elapsed = xTaskGetTickCount() - t0;
+            if( elapsed >= ( TickType_t ) timeout )
+            {
+                rflags = osFlagsErrorTimeout;
+                break;
+            }
+            td = ( TickType_t ) timeout - elapsed;
+        }
+    }
+
+    return rflags;
+}
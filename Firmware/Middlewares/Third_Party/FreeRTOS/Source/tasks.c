@@ -60,6 +60,10 @@ typedef struct tskTaskControlBlock
         uint8_t ucDeleted;
     #endif
 
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        uint32_t ulRunTimeCounter;       /**< Run-time counter ticks spent running */
+    #endif
+
     uint8_t ucStaticallyAllocated;
 
 } TCB_t;
@@ -110,6 +114,11 @@ static volatile BaseType_t  xTaskMissedYield         = pdFALSE;
 /* Idle task */
 static TCB_t * volatile pxIdleTaskHandle             = NULL;
 
+/* Run-time stats: counter value when the current task was switched in */
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+    static uint32_t ulTaskSwitchedInTime = 0UL;
+#endif
+
 /* Pending ready list – tasks added here when the scheduler is suspended */
 static List_t xPendingReadyList;
 
@@ -333,6 +342,12 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
     }
     #endif
 
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+    {
+        pxNewTCB->ulRunTimeCounter = 0UL;
+    }
+    #endif
+
     /* Initialize the new task's top-of-stack pointer. */
     pxNewTCB->pxTopOfStack = pxPortInitialiseStack( pxTopOfStack,
                                                      pxTaskCode,
@@ -629,6 +644,7 @@ void vTaskStartScheduler( void )
         #if ( configGENERATE_RUN_TIME_STATS == 1 )
         {
             portCONFIGURE_TIMER_FOR_RUN_TIME_STATS();
+            ulTaskSwitchedInTime = portGET_RUN_TIME_COUNTER_VALUE();
         }
         #endif
 
@@ -953,7 +969,12 @@ portDONT_DISCARD void vTaskSwitchContext( void )
 
         #if ( configGENERATE_RUN_TIME_STATS == 1 )
         {
-            /* Nothing needed here */
+            /* Charge the outgoing task for its time slice.  The difference is
+             * taken unsigned, so a counter that wraps (DWT CYCCNT wraps every
+             * ~8.9 s) is handled as long as no single slice is that long. */
+            uint32_t ulNow = portGET_RUN_TIME_COUNTER_VALUE();
+            pxCurrentTCB->ulRunTimeCounter += ( ulNow - ulTaskSwitchedInTime );
+            ulTaskSwitchedInTime = ulNow;
         }
         #endif
 
@@ -1650,6 +1671,8 @@ BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify,
                 break;
         }
 
+        traceTASK_NOTIFY( uxIndexToNotify );
+
         if( ucOriginalNotifyState == taskWAITING_NOTIFICATION )
         {
             ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
@@ -1721,6 +1744,8 @@ BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify,
                 break;
         }
 
+        traceTASK_NOTIFY_FROM_ISR( uxIndexToNotify );
+
         if( ucOriginalNotifyState == taskWAITING_NOTIFICATION )
         {
             ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
@@ -1777,6 +1802,7 @@ BaseType_t xTaskGenericNotifyWait( UBaseType_t uxIndexToWaitOn,
 
             if( xTicksToWait > ( TickType_t ) 0 )
             {
+                traceTASK_NOTIFY_WAIT_BLOCK( uxIndexToWaitOn );
                 prvAddCurrentTaskToDelayedList( xTicksToWait, pdTRUE );
                 portYIELD_WITHIN_API();
             }
@@ -1824,6 +1850,7 @@ uint32_t ulTaskGenericNotifyTake( UBaseType_t uxIndexToWaitOn,
 
             if( xTicksToWait > ( TickType_t ) 0 )
             {
+                traceTASK_NOTIFY_TAKE_BLOCK( uxIndexToWaitOn );
                 prvAddCurrentTaskToDelayedList( xTicksToWait, pdTRUE );
                 portYIELD_WITHIN_API();
             }
@@ -1903,20 +1930,168 @@ uint32_t ulTaskGenericNotifyValueClear( TaskHandle_t xTask,
 #endif /* configUSE_TASK_NOTIFICATIONS */
 /* ----------------------------------------------------------------------- */
 
+#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) )
+
+/* Words at the end of the stack that still hold the fill pattern */
+static configSTACK_DEPTH_TYPE prvTaskCheckFreeStackSpace( const uint8_t * pucStackByte )
+{
+    uint32_t ulCount = 0U;
+
+    while( *pucStackByte == ( uint8_t ) tskSTACK_FILL_BYTE )
+    {
+        pucStackByte -= portSTACK_GROWTH;
+        ulCount++;
+    }
+
+    ulCount /= ( uint32_t ) sizeof( StackType_t );
+
+    return ( configSTACK_DEPTH_TYPE ) ulCount;
+}
+
+#endif
+/* ----------------------------------------------------------------------- */
+
+#if ( INCLUDE_uxTaskGetStackHighWaterMark == 1 )
+
+UBaseType_t uxTaskGetStackHighWaterMark( TaskHandle_t xTask )
+{
+    TCB_t * pxTCB = ( xTask == NULL ) ? pxCurrentTCB : ( TCB_t * ) xTask;
+
+    #if ( portSTACK_GROWTH < 0 )
+        return ( UBaseType_t ) prvTaskCheckFreeStackSpace( ( uint8_t * ) pxTCB->pxStack );
+    #else
+        return ( UBaseType_t ) prvTaskCheckFreeStackSpace( ( uint8_t * ) pxTCB->pxEndOfStack );
+    #endif
+}
+
+#endif /* INCLUDE_uxTaskGetStackHighWaterMark */
+/* ----------------------------------------------------------------------- */
+
 #if ( configUSE_TRACE_FACILITY == 1 )
 
+static void prvGetTaskInfo( TCB_t * pxTCB,
+                            TaskStatus_t * pxTaskStatus,
+                            eTaskState eState )
+{
+    pxTaskStatus->xHandle           = ( TaskHandle_t ) pxTCB;
+    pxTaskStatus->pcTaskName        = ( const char * ) &( pxTCB->pcTaskName[ 0 ] );
+    pxTaskStatus->uxCurrentPriority = pxTCB->uxPriority;
+    pxTaskStatus->pxStackBase       = pxTCB->pxStack;
+    pxTaskStatus->xTaskNumber       = pxTCB->uxTCBNumber;
+
+    #if ( configUSE_MUTEXES == 1 )
+        pxTaskStatus->uxBasePriority = pxTCB->uxBasePriority;
+    #else
+        pxTaskStatus->uxBasePriority = 0;
+    #endif
+
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        pxTaskStatus->ulRunTimeCounter = pxTCB->ulRunTimeCounter;
+    #else
+        pxTaskStatus->ulRunTimeCounter = 0;
+    #endif
+
+    if( pxTCB == pxCurrentTCB )
+    {
+        eState = eRunning;
+    }
+    #if ( INCLUDE_vTaskSuspend == 1 )
+    else if( ( eState == eSuspended ) &&
+             ( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL ) )
+    {
+        /* Blocked indefinitely on an event, not suspended */
+        eState = eBlocked;
+    }
+    #endif
+    pxTaskStatus->eCurrentState = eState;
+
+    #if ( portSTACK_GROWTH > 0 )
+        pxTaskStatus->usStackHighWaterMark =
+            prvTaskCheckFreeStackSpace( ( uint8_t * ) pxTCB->pxEndOfStack );
+    #else
+        pxTaskStatus->usStackHighWaterMark =
+            prvTaskCheckFreeStackSpace( ( uint8_t * ) pxTCB->pxStack );
+    #endif
+}
+
+static UBaseType_t prvListTasksWithinSingleList( TaskStatus_t * pxTaskStatusArray,
+                                                 List_t * pxList,
+                                                 eTaskState eState )
+{
+    configLIST_VOLATILE TCB_t * pxNextTCB, * pxFirstTCB;
+    UBaseType_t uxTask = 0;
+
+    if( listCURRENT_LIST_LENGTH( pxList ) > ( UBaseType_t ) 0 )
+    {
+        /* Walks the whole list once, so pxIndex ends where it started and
+         * round-robin order is not disturbed. */
+        listGET_OWNER_OF_NEXT_ENTRY( pxFirstTCB, pxList );
+        do
+        {
+            listGET_OWNER_OF_NEXT_ENTRY( pxNextTCB, pxList );
+            prvGetTaskInfo( ( TCB_t * ) pxNextTCB, &( pxTaskStatusArray[ uxTask ] ), eState );
+            uxTask++;
+        } while( pxNextTCB != pxFirstTCB );
+    }
+
+    return uxTask;
+}
+
 UBaseType_t uxTaskGetSystemState( TaskStatus_t * const pxTaskStatusArray,
                                    const UBaseType_t uxArraySize,
                                    uint32_t * const pulTotalRunTime )
 {
-    /* Minimal stub – not used in this project */
-    ( void ) pxTaskStatusArray;
-    ( void ) uxArraySize;
-    if( pulTotalRunTime != NULL )
+    UBaseType_t uxTask = 0, uxQueue = configMAX_PRIORITIES;
+
+    vTaskSuspendAll();
     {
-        *pulTotalRunTime = 0;
+        /* Is there a space in the array for each task in the system? */
+        if( uxArraySize >= uxCurrentNumberOfTasks )
+        {
+            do
+            {
+                uxQueue--;
+                uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ),
+                                                        &( pxReadyTasksLists[ uxQueue ] ),
+                                                        eReady );
+            } while( uxQueue > ( UBaseType_t ) tskIDLE_PRIORITY );
+
+            uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ),
+                                                    ( List_t * ) pxDelayedTaskList,
+                                                    eBlocked );
+            uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ),
+                                                    ( List_t * ) pxOverflowDelayedTaskList,
+                                                    eBlocked );
+
+            #if ( INCLUDE_vTaskDelete == 1 )
+            {
+                uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ),
+                                                        &xTasksWaitingTermination,
+                                                        eDeleted );
+            }
+            #endif
+
+            #if ( INCLUDE_vTaskSuspend == 1 )
+            {
+                uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ),
+                                                        &xSuspendedTaskList,
+                                                        eSuspended );
+            }
+            #endif
+
+            if( pulTotalRunTime != NULL )
+            {
+                #if ( configGENERATE_RUN_TIME_STATS == 1 )
+                    *pulTotalRunTime = portGET_RUN_TIME_COUNTER_VALUE();
+                #else
+                    *pulTotalRunTime = 0;
+                #endif
+            }
+        }
     }
-    return 0;
+    ( void ) xTaskResumeAll();
+
+    return uxTask;
 }
 
 void vTaskSetTaskNumber( TaskHandle_t xTask, const UBaseType_t uxHandle )
@@ -0,0 +1,143 @@
+using System;
+using System.Numerics;
+
+namespace FifoBridge.Common;
+
+/// <summary>
+/// PRBS-31 (x^31 + x^28 + 1) byte generator and checker, bit-for-bit the
+/// same stream as Firmware/Core/Inc/prbs.h.
+///
+/// The sequence is packed eight bits per byte, earliest bit in the MSB.
+/// The 31-bit state is the last 31 bits sent, so a checker locks on from
+/// any four consecutive bytes; no seed has to be agreed on.
+/// </summary>
+public sealed class Prbs31
+{
+    private const uint Mask = 0x7FFFFFFFu;
+
+    private uint _state;
+
+    /// <summary>Start a generator from <paramref name="seed"/> (any non-zero 31-bit value).</summary>
+    public Prbs31(uint seed = 1)
+    {
+        seed  &= Mask;
+        _state = seed != 0 ? seed : 1u;
+    }
+
+    /// <summary>Next eight bits of the sequence.</summary>
+    public byte Next()
+    {
+        uint s   = _state;
+        uint b   = ((s >> 23) ^ (s >> 20)) & 0xFF;
+        _state   = ((s << 8) | b) & Mask;
+        return (byte)b;
+    }
+
+    /// <summary>Next 24 bits, earliest bit in bit 23 (both taps are still in the state).</summary>
+    private uint Next24()
+    {
+        uint s   = _state;
+        uint w   = ((s >> 7) ^ (s >> 4)) & 0xFFFFFFu;
+        _state   = ((s << 24) | w) & Mask;
+        return w;
+    }
+
+    /// <summary>Fill <paramref name="dst"/> with the next bytes of the sequence.</summary>
+    public void Fill(Span<byte> dst)
+    {
+        int i = 0;
+        for (; i + 3 <= dst.Length; i += 3)
+        {
+            uint w     = Next24();
+            dst[i]     = (byte)(w >> 16);
+            dst[i + 1] = (byte)(w >> 8);
+            dst[i + 2] = (byte)w;
+        }
+        for (; i < dst.Length; i++)
+            dst[i] = Next();
+    }
+
+    /// <summary>
+    /// Lock onto a received stream from four consecutive bytes.
+    /// Returns false if they are all zero (not a PRBS-31 stream).
+    /// </summary>
+    public bool Sync(ReadOnlySpan<byte> b)
+    {
+        _state = (((uint)b[0] << 24) | ((uint)b[1] << 16) |
+                  ((uint)b[2] << 8)  |  b[3]) & Mask;
+        return _state != 0;
+    }
+
+    /// <summary>
+    /// Compare received bytes against the sequence and return the number of
+    /// bit errors.  A dropped or repeated byte shows up as a burst of errors.
+    /// </summary>
+    public int Check(ReadOnlySpan<byte> src)
+    {
+        int errors = 0;
+        int i      = 0;
+        for (; i + 3 <= src.Length; i += 3)
+        {
+            uint got = ((uint)src[i] << 16) | ((uint)src[i + 1] << 8) | src[i + 2];
+            errors += BitOperations.PopCount(got ^ Next24());
+        }
+        for (; i < src.Length; i++)
+            errors += BitOperations.PopCount((uint)(src[i] ^ Next()));
+        return errors;
+    }
+}
+
+/// <summary>
+/// PRBS-31 stream checker with lock tracking, same rules as the firmware's
+/// PrbsCheckTask (fifo_prbs.c): a chunk with more than one bit error in
+/// <see cref="LossRatio"/> counts as lost lock and relocks on its last four
+/// bytes instead of adding to <see cref="Errors"/>.
+/// </summary>
+public sealed class Prbs31Checker
+{
+    public const int LossRatio = 4;
+
+    private readonly Prbs31 _prbs = new();
+    private readonly byte[] _sync = new byte[4];
+    private int             _syncLen;
+
+    public bool Locked  { get; private set; }
+    public long Checked { get; private set; }   // bytes compared while locked
+    public long Errors  { get; private set; }   // bit errors in those bytes
+    public long Resyncs { get; private set; }   // chunks dropped for lost lock
+
+    public double BitErrorRate => Checked > 0 ? Errors / (Checked * 8.0) : 0;
+
+    public void Feed(ReadOnlySpan<byte> data)
+    {
+        while (!Locked && data.Length > 0)
+        {
+            _sync[0] = _sync[1]; _sync[1] = _sync[2]; _sync[2] = _sync[3];
+            _sync[3] = data[0];
+            data     = data[1..];
+            if (++_syncLen >= 4)
+                Lock(_sync);
+        }
+        if (data.Length == 0)
+            return;
+
+        int errors = _prbs.Check(data);
+        if (errors > data.Length * 8 / LossRatio)
+        {
+            Resyncs++;
+            if (data.Length >= 4)
+                Lock(data[^4..]);
+            else
+                Locked = false;
+            return;
+        }
+        Checked += data.Length;
+        Errors  += errors;
+    }
+
+    private void Lock(ReadOnlySpan<byte> last4)
+    {
+        Locked   = _prbs.Sync(last4);
+        _syncLen = 0;
+    }
+}
@@ -22,6 +22,14 @@ namespace FifoBridge.Common;
 ///
 ///   Trailer:
 ///     [4]  PayloadCRC32   (CRC32 of all payload bytes)
+///
+///   Telemetry frame (bridge firmware built with BRIDGE_TELEMETRY=1; only
+///   ever sent between transfers, see Firmware/Core/Inc/fifo_tele.h):
+///     [4]  Magic          = 0x46494654  ("FIFT")
+///     [2]  Version        = 1
+///     [2]  Length         (body bytes; 48 in version 1)
+///     [L]  Body           (uint32 counters, see <see cref="Telemetry"/>)
+///     [4]  FrameCRC32     (CRC32 of all preceding frame bytes)
 /// </summary>
 public static class TransferProtocol
 {
@@ -29,6 +37,9 @@ public static class TransferProtocol
     public const ushort Version      = 1;
     public const int   ChunkSize     = 65536;       // read/write chunk (bytes)
 
+    public const uint  TelemetryMagic   = 0x46494654u; // "FIFT"
+    public const int   TelemetryBodyV1  = 48;          // body bytes in version 1
+
     // -----------------------------------------------------------------------
     // CRC-32 (ISO 3309 / ITU-T V.42 – same polynomial as zlib/zip)
     // -----------------------------------------------------------------------
@@ -98,15 +109,26 @@ public static class TransferProtocol
 
     /// <summary>
     /// Read and validate a transfer header from <paramref name="reader"/>.
+    /// Telemetry frames in front of the header are validated and handed to
+    /// <paramref name="onTelemetry"/> (or dropped if it is null).
     /// Throws <see cref="InvalidDataException"/> on format or CRC mismatch.
     /// </summary>
-    public static FileHeader ReadHeader(BinaryReader reader)
+    public static FileHeader ReadHeader(BinaryReader reader,
+                                        Action<Telemetry>? onTelemetry = null)
     {
+        uint magic = reader.ReadUInt32();
+        while (magic == TelemetryMagic)
+        {
+            var telemetry = ReadTelemetry(reader);
+            onTelemetry?.Invoke(telemetry);
+            magic = reader.ReadUInt32();
+        }
+
         // We need to capture all header bytes for CRC check.
         using var capture = new MemoryStream();
         using var capWriter = new BinaryWriter(capture, Encoding.UTF8, leaveOpen: true);
 
-        uint magic = reader.ReadUInt32(); capWriter.Write(magic);
+        capWriter.Write(magic);
         if (magic != Magic)
             throw new InvalidDataException($"Bad magic: 0x{magic:X8}");
 
@@ -130,4 +152,62 @@ public static class TransferProtocol
         string filename = Encoding.UTF8.GetString(nameBytes);
         return new FileHeader(filename, (long)fileSize);
     }
+
+    // -----------------------------------------------------------------------
+    // Telemetry frames
+    // -----------------------------------------------------------------------
+
+    /// <summary>
+    /// One bridge telemetry frame.  Counters are 32-bit and wrap; compare two
+    /// frames with unchecked subtraction.
+    /// </summary>
+    public record Telemetry(
+        uint   Seq,
+        uint   UptimeMs,
+        uint   BytesIn,       // read from FIFO#1
+        uint   BytesOut,      // stream bytes accepted by FIFO#2
+        uint   RingFull,      // read leg found the ring buffer full
+        uint   Fifo2Full,     // write leg found TXE# high
+        uint   Late,          // strobe bursts cut short
+        uint   BufPeak,       // ring buffer peak since the previous frame
+        uint   BufSize,
+        uint   CrcBadIn,      // bad transfers seen by the bridge on FIFO#1
+        uint   CrcBadOut,     // ... and on FIFO#2
+        double CpuLoad,       // 0..1 since the previous frame
+        bool   CrcChecked,    // CrcBad* are counted (BRIDGE_CRC=1)
+        bool   CalibFallback); // a CPU leg runs on fallback strobe timing
+
+    /// <summary>
+    /// Read the rest of a telemetry frame whose magic has just been read.
+    /// Later versions may append fields; the version 1 fields are parsed
+    /// and any further body bytes skipped.
+    /// </summary>
+    private static Telemetry ReadTelemetry(BinaryReader reader)
+    {
+        ushort version = reader.ReadUInt16();
+        ushort length  = reader.ReadUInt16();
+        byte[] body    = reader.ReadBytes(length);
+        uint   crc     = reader.ReadUInt32();
+        if (body.Length != length)
+            throw new EndOfStreamException();
+
+        uint running = Crc32Update(0xFFFFFFFFu, BitConverter.GetBytes(TelemetryMagic));
+        running = Crc32Update(running, BitConverter.GetBytes(version));
+        running = Crc32Update(running, BitConverter.GetBytes(length));
+        uint expectedCrc = Crc32Update(running, body) ^ 0xFFFFFFFFu;
+        if (crc != expectedCrc)
+            throw new InvalidDataException(
+                $"Telemetry CRC mismatch: expected 0x{expectedCrc:X8}, got 0x{crc:X8}");
+        if (version < 1 || length < TelemetryBodyV1)
+            throw new InvalidDataException($"Unknown telemetry version {version}");
+
+        uint U32(int i) => BitConverter.ToUInt32(body, 4 * i);
+        ushort cpu   = BitConverter.ToUInt16(body, 44);
+        ushort flags = BitConverter.ToUInt16(body, 46);
+
+        return new Telemetry(
+            U32(0), U32(1), U32(2), U32(3), U32(4), U32(5), U32(6),
+            U32(7), U32(8), U32(9), U32(10),
+            cpu / 1000.0, (flags & 0x0001) != 0, (flags & 0x0002) != 0);
+    }
 }
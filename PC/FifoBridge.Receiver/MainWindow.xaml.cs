@@ -12,6 +12,7 @@ public partial class MainWindow : Window
 {
     private string?                  _outputFolder;
     private CancellationTokenSource? _cts;
+    private TransferProtocol.Telemetry? _lastTelemetry;
 
     public MainWindow() => InitializeComponent();
 
@@ -80,6 +81,42 @@ public partial class MainWindow : Window
         }
     }
 
+    // -----------------------------------------------------------------------
+    // PRBS test
+    // -----------------------------------------------------------------------
+    private async void PrbsClick(object sender, RoutedEventArgs e)
+    {
+        string serial = SerialBox.Text.Trim();
+        if (string.IsNullOrWhiteSpace(serial))
+        {
+            MessageBox.Show("Enter the receiver device serial number.", "Validation",
+                            MessageBoxButton.OK, MessageBoxImage.Warning);
+            return;
+        }
+
+        SetBusy(true);
+        _cts = new CancellationTokenSource();
+        var token = _cts.Token;
+
+        try
+        {
+            await Task.Run(() => DoPrbs(serial, token), token);
+        }
+        catch (OperationCanceledException)
+        {
+            Dispatcher.InvokeAsync(() =>
+                StatusLabel.Text = "PRBS test stopped.  " + StatusLabel.Text);
+        }
+        catch (Exception ex)
+        {
+            SetStatus($"Error: {ex.Message}", success: false);
+        }
+        finally
+        {
+            SetBusy(false);
+        }
+    }
+
     // -----------------------------------------------------------------------
     // Cancel
     // -----------------------------------------------------------------------
@@ -103,7 +140,7 @@ public partial class MainWindow : Window
         using var br         = new BinaryReader(fifoStream,
                                 System.Text.Encoding.UTF8, leaveOpen: true);
 
-        var header = TransferProtocol.ReadHeader(br);
+        var header = TransferProtocol.ReadHeader(br, ShowTelemetry);
 
         // Sanitise filename (strip any path components from sender)
         string safeFilename = Path.GetFileName(header.Filename);
@@ -187,6 +224,99 @@ public partial class MainWindow : Window
         return outputPath;
     }
 
+    // -----------------------------------------------------------------------
+    // PRBS test check (runs on thread-pool thread until cancelled)
+    // -----------------------------------------------------------------------
+
+    /// <summary>
+    /// Check the PRBS-31 stream from the bridge's PrbsGenTask, measuring the
+    /// FIFO#2 leg on its own (see Firmware/Core/Inc/fifo_prbs.h).
+    /// </summary>
+    private void DoPrbs(string serial, CancellationToken ct)
+    {
+        using var ft         = D2xx.OpenBySerial(serial);
+        using var fifoStream = new FifoReadStream(ft, ct);
+
+        var  checker   = new Prbs31Checker();
+        var  buf       = new byte[TransferProtocol.ChunkSize];
+        long received  = 0;
+        var  sw        = Stopwatch.StartNew();
+        long lastBytes = 0;
+        long lastMs    = 0;
+
+        while (true)
+        {
+            int got = fifoStream.Read(buf, 0, buf.Length);
+            checker.Feed(buf.AsSpan(0, got));
+            received += got;
+
+            long nowMs = sw.ElapsedMilliseconds;
+            if (nowMs - lastMs >= 500)
+            {
+                double speedMbs = (received - lastBytes) / ((nowMs - lastMs) / 1000.0)
+                                  / 1_048_576.0;
+                string text = $"PRBS-31: {speedMbs:F2} MB/s  –  " +
+                              $"{checker.Errors} bit errors in {checker.Checked:N0} bytes " +
+                              $"(BER {checker.BitErrorRate:0.##E+0}), " +
+                              $"{checker.Resyncs} resyncs" +
+                              (checker.Locked ? "" : ", not locked");
+                bool clean = checker.Errors == 0 && checker.Resyncs == 0;
+                lastBytes = received;
+                lastMs    = nowMs;
+
+                Dispatcher.InvokeAsync(() =>
+                {
+                    StatusLabel.Text       = text;
+                    StatusLabel.Foreground = clean
+                        ? System.Windows.Media.Brushes.DarkBlue
+                        : System.Windows.Media.Brushes.Red;
+                });
+            }
+        }
+    }
+
+    // -----------------------------------------------------------------------
+    // Telemetry
+    // -----------------------------------------------------------------------
+
+    /// <summary>
+    /// Show a bridge telemetry frame.  Rates and stall counts are the
+    /// differences to the previous frame; the first frame only shows load.
+    /// </summary>
+    private void ShowTelemetry(TransferProtocol.Telemetry t)
+    {
+        var    prev = _lastTelemetry;
+        string text = $"CPU {t.CpuLoad * 100:F1}%  –  ring peak " +
+                      $"{t.BufPeak * 100.0 / Math.Max(t.BufSize, 1u):F0}%";
+
+        if (prev is not null && t.Seq == unchecked(prev.Seq + 1))
+        {
+            double s = unchecked(t.UptimeMs - prev.UptimeMs) / 1000.0;
+            if (s > 0)
+            {
+                double inMBs  = unchecked(t.BytesIn  - prev.BytesIn)  / s / 1_048_576.0;
+                double outMBs = unchecked(t.BytesOut - prev.BytesOut) / s / 1_048_576.0;
+                text = $"In {inMBs:F2} MB/s  Out {outMBs:F2} MB/s  –  " + text;
+            }
+            text += $"\nStalls: ring full {unchecked(t.RingFull - prev.RingFull)}, " +
+                    $"FIFO#2 full {unchecked(t.Fifo2Full - prev.Fifo2Full)}, " +
+                    $"late {unchecked(t.Late - prev.Late)}";
+        }
+        if (t.CrcChecked)
+            text += $"  –  CRC bad in/out {t.CrcBadIn}/{t.CrcBadOut}";
+        if (t.CalibFallback)
+            text += "\nStrobe calibration failed: running on pulsed fallback timing";
+
+        _lastTelemetry = t;
+        Dispatcher.InvokeAsync(() =>
+        {
+            TelemetryLabel.Text       = text;
+            TelemetryLabel.Foreground = t.CalibFallback
+                ? System.Windows.Media.Brushes.DarkRed
+                : System.Windows.Media.Brushes.DarkBlue;
+        });
+    }
+
     // -----------------------------------------------------------------------
     // Helpers
     // -----------------------------------------------------------------------
@@ -242,6 +372,7 @@ public partial class MainWindow : Window
         Dispatcher.InvokeAsync(() =>
         {
             ReceiveButton.IsEnabled = !busy;
+            PrbsButton.IsEnabled    = !busy;
             CancelButton.IsEnabled  = busy;
         });
     }
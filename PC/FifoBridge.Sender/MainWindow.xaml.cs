@@ -69,6 +69,41 @@ public partial class MainWindow : Window
         }
     }
 
+    // -----------------------------------------------------------------------
+    // PRBS test
+    // -----------------------------------------------------------------------
+    private async void PrbsClick(object sender, RoutedEventArgs e)
+    {
+        string serial = SerialBox.Text.Trim();
+        if (string.IsNullOrWhiteSpace(serial))
+        {
+            MessageBox.Show("Enter the sender device serial number.", "Validation",
+                            MessageBoxButton.OK, MessageBoxImage.Warning);
+            return;
+        }
+
+        SetBusy(true);
+        _cts = new CancellationTokenSource();
+        var token = _cts.Token;
+
+        try
+        {
+            await Task.Run(() => DoPrbs(serial, token), token);
+        }
+        catch (OperationCanceledException)
+        {
+            SetStatus("PRBS test stopped.", success: true);
+        }
+        catch (Exception ex)
+        {
+            SetStatus($"Error: {ex.Message}", success: false);
+        }
+        finally
+        {
+            SetBusy(false);
+        }
+    }
+
     // -----------------------------------------------------------------------
     // Cancel
     // -----------------------------------------------------------------------
@@ -143,6 +178,52 @@ public partial class MainWindow : Window
         ft.Write(trailer, 0, 4);
     }
 
+    // -----------------------------------------------------------------------
+    // PRBS test stream (runs on thread-pool thread until cancelled)
+    // -----------------------------------------------------------------------
+
+    /// <summary>
+    /// Stream PRBS-31 into FIFO#1 so the bridge's PrbsCheckTask can measure
+    /// the FIFO#1 leg on its own (see Firmware/Core/Inc/fifo_prbs.h).
+    /// </summary>
+    private void DoPrbs(string serial, CancellationToken ct)
+    {
+        using var ft = D2xx.OpenBySerial(serial);
+
+        var  prbs      = new Prbs31((uint)Environment.TickCount | 1u);
+        var  buf       = new byte[TransferProtocol.ChunkSize];
+        long sent      = 0;
+        var  sw        = Stopwatch.StartNew();
+        long lastBytes = 0;
+        long lastMs    = 0;
+
+        while (true)
+        {
+            ct.ThrowIfCancellationRequested();
+
+            prbs.Fill(buf);
+            ft.Write(buf, 0, buf.Length);
+            sent += buf.Length;
+
+            long nowMs = sw.ElapsedMilliseconds;
+            if (nowMs - lastMs >= 500)
+            {
+                double speedMbs = (sent - lastBytes) / ((nowMs - lastMs) / 1000.0)
+                                  / 1_048_576.0;
+                double avgMbs   = sent / (nowMs / 1000.0) / 1_048_576.0;
+                lastBytes = sent;
+                lastMs    = nowMs;
+
+                Dispatcher.InvokeAsync(() =>
+                {
+                    StatusLabel.Text = $"PRBS-31: {sent / 1_048_576.0:F0} MB sent  –  " +
+                                       $"{speedMbs:F2} MB/s (avg {avgMbs:F2})";
+                    StatusLabel.Foreground = System.Windows.Media.Brushes.DarkBlue;
+                });
+            }
+        }
+    }
+
     // -----------------------------------------------------------------------
     // UI helpers
     // -----------------------------------------------------------------------
@@ -151,6 +232,7 @@ public partial class MainWindow : Window
         Dispatcher.InvokeAsync(() =>
         {
             SendButton.IsEnabled   = !busy && _filePath is not null;
+            PrbsButton.IsEnabled   = !busy;
             CancelButton.IsEnabled = busy;
         });
     }